@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Wavetable mixer for short sine tones (no Arduino dependencies, also built by the host tests)
+//   Voices have linear attack and release ramps and are summed into 16-bit
+//   mono buffers; a new tone steals the voice closest to its end if all are busy.
+class AudioMixer {
+public:
+    // Output format
+    static constexpr uint32_t SAMPLE_RATE = 24000U;
+    static constexpr std::size_t BUFFER_SAMPLES = 256U;     // about 10.7 ms per buffer
+
+    // Maximum number of simultaneous tones
+    static constexpr std::size_t MAX_VOICE_COUNT = 4U;
+
+    // Peak amplitude of a single tone (four voices stay below full scale)
+    static constexpr int16_t WAVETABLE_AMPLITUDE = 8000;
+
+    // Constructor
+    AudioMixer();
+
+    // Start a tone after the given delay
+    void startTone(float frequency, uint32_t durationMs, uint32_t delayMs);
+
+    // Mix active voices into a buffer of BUFFER_SAMPLES samples (returns false if no voice is active)
+    bool mix(int16_t* buffer);
+
+    // Get number of active voices (including delayed ones)
+    std::size_t getActiveVoiceCount() const;
+
+private:
+    // Voice state
+    struct Voice {
+        bool isActive;
+        uint32_t phase;             // wavetable phase (upper 8 bits index the table)
+        uint32_t phaseIncrement;
+        uint32_t delaySamples;      // samples to wait before starting
+        uint32_t elapsedSamples;
+        uint32_t remainingSamples;
+    };
+
+    // Mixer settings
+    static constexpr std::size_t WAVETABLE_SIZE = 256U;
+    static constexpr uint32_t ATTACK_SHIFT = 6U;            // 64-sample attack ramp
+    static constexpr uint32_t RELEASE_SHIFT = 8U;           // 256-sample release ramp
+
+    // Voices
+    Voice voices[MAX_VOICE_COUNT] = {};
+
+    // Sine wavetable
+    int16_t wavetable[WAVETABLE_SIZE] = {};
+};
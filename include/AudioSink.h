@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Interface for destinations of mixed audio
+//   The audio task writes one buffer at a time; a sink may keep a reference
+//   to the buffer until it has been played, so the caller rotates buffers.
+class AudioSink {
+public:
+    // Destructor
+    virtual ~AudioSink() {}
+
+    // Prepare the sink (called once before the first buffer)
+    virtual void begin() = 0;
+
+    // Block until the sink can take another buffer
+    virtual void waitForRoom() = 0;
+
+    // Check if the sink has played everything written so far
+    virtual bool isDrained() const = 0;
+
+    // Write a buffer of 16-bit mono samples (returns false if it was not accepted)
+    virtual bool write(const int16_t* samples, std::size_t count, uint32_t sampleRate) = 0;
+};
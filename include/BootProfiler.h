@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_timer.h>
+
+// Class for timestamping boot milestones
+class BootProfiler {
+public:
+    // Constructor
+    BootProfiler();
+
+    // Timestamp a milestone (name must be a string literal)
+    void mark(const char* name);
+
+    // Print milestones with time since boot and since the previous milestone
+    void report(Print& output) const;
+
+private:
+    // Milestone
+    struct Milestone {
+        const char* name;
+        int64_t timeUs;
+    };
+
+    // Maximum number of milestones
+    static constexpr std::size_t MAX_MILESTONE_COUNT = 16U;
+
+    // Recorded milestones
+    Milestone milestones[MAX_MILESTONE_COUNT] = {};
+    std::atomic<std::size_t> milestoneCount{0};
+};
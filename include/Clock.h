@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+// Monotonic clock in microseconds
+//   The firmware passes esp_timer_get_time; host tests pass a clock they advance themselves.
+typedef int64_t (*ClockFunction)();
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdio>
+#include "AudioSink.h"
+
+// Class for writing mixed audio to a file as raw 16-bit little-endian mono PCM
+//   Used by the host tests; the file is never full, so it is always drained.
+class FileAudioSink : public AudioSink {
+public:
+    // Constructor (the file is not owned by the sink)
+    explicit FileAudioSink(FILE* file);
+
+    // Destructor
+    ~FileAudioSink();
+
+    // Nothing to prepare
+    void begin() override {}
+
+    // Files always have room
+    void waitForRoom() override {}
+
+    // Files never run dry
+    bool isDrained() const override { return false; }
+
+    // Append a buffer to the file
+    bool write(const int16_t* samples, std::size_t count, uint32_t sampleRate) override;
+
+    // Get number of samples written
+    std::size_t getSampleCount() const { return sampleCount; }
+
+private:
+    // Output file
+    FILE* file;
+
+    // Number of samples written
+    std::size_t sampleCount = 0;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Class for per-frame scratch memory
+//   The buffer is allocated once; allocate() bumps an offset and reset()
+//   releases everything at the start of the next frame, so the frame loop
+//   never touches the heap.
+class FrameArena {
+public:
+    // Constructor
+    FrameArena(std::size_t capacity);
+
+    // Destructor
+    ~FrameArena();
+
+    // Allocate uninitialized storage for count objects (returns nullptr if the arena is exhausted)
+    template<typename T>
+    T* allocate(std::size_t count) {
+        const std::size_t alignment = alignof(T);
+        const std::size_t start = (offset + alignment - 1) & ~(alignment - 1);
+        const std::size_t end = start + count * sizeof(T);
+
+        if (!buffer || end > capacity) {
+            ++overflowCount;
+            return nullptr;
+        }
+
+        offset = end;
+        if (offset > highWaterMark) {
+            highWaterMark = offset;
+        }
+
+        return reinterpret_cast<T*>(buffer + start);
+    }
+
+    // Release all allocations
+    void reset() { offset = 0; }
+
+    // Get statistics
+    std::size_t getCapacity() const { return capacity; }
+    std::size_t getHighWaterMark() const { return highWaterMark; }
+    uint32_t getOverflowCount() const { return overflowCount; }
+
+private:
+    // Scratch buffer
+    uint8_t* buffer = nullptr;
+    std::size_t capacity = 0;
+
+    // Current offset
+    std::size_t offset = 0;
+
+    // Statistics
+    std::size_t highWaterMark = 0;
+    uint32_t overflowCount = 0;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_heap_caps.h>
+
+// Class for checking that the frame loop does not allocate
+//   Free heap is sampled per capability after every frame to track the
+//   low-water marks. When built with -DVORONOI_HEAP_DEBUG, every allocation
+//   made by the watched task after the warmup frames is counted as a
+//   violation. With CONFIG_HEAP_USE_HOOKS the ESP-IDF heap hook sees every
+//   allocation (malloc, heap_caps_malloc and operator new); without it, as in
+//   the PlatformIO Arduino build with its prebuilt core, only operator new is hooked.
+class HeapMonitor {
+public:
+    // Constructor
+    HeapMonitor();
+
+    // Watch the calling task (allocations during the first warmup frames are allowed)
+    void watchCurrentTask(uint32_t warmupFrames);
+
+    // Sample free heap and check allocations at the end of a frame
+    void endFrame();
+
+    // Print allocation counts and heap low-water marks (returns false if the check failed)
+    bool report(Print& output);
+
+    // Check that the watched task has not allocated since warmup
+    bool isPassing() const { return allocationCount.load() == 0; }
+
+    // Get number of allocations made by the watched task since warmup
+    uint32_t getAllocationCount() const { return allocationCount.load(); }
+
+    // Record an allocation (called from the heap hook or the operator new hook)
+    static void recordAllocation(std::size_t size);
+
+private:
+    // Heap capability to track
+    struct HeapCapability {
+        const char* name;
+        uint32_t caps;
+    };
+
+    // Number of tracked capabilities
+    static constexpr std::size_t CAPABILITY_COUNT = 3U;
+
+    // Tracked capabilities
+    static const HeapCapability CAPABILITIES[CAPABILITY_COUNT];
+
+    // Low-water marks of free heap per capability
+    std::size_t lowWaterMarks[CAPABILITY_COUNT] = {};
+
+    // Frames seen since watching started
+    uint32_t frameCount = 0;
+    uint32_t warmupFrameCount = 0;
+
+    // Frames in which the watched task allocated after warmup
+    uint32_t violatingFrameCount = 0;
+
+    // Allocation count at the end of the previous frame
+    uint32_t lastAllocationCount = 0;
+
+    // Allocation counter state shared with the operator new hook
+    static TaskHandle_t watchedTask;
+    static std::atomic<bool> isCountingEnabled;
+    static std::atomic<uint32_t> allocationCount;
+    static std::atomic<uint32_t> allocatedBytes;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+// Host builds (tests) have no tasks to notify
+#include <cstdint>
+typedef void* TaskHandle_t;
+#endif
+
+// Interface for sources of touch input
+class InputSource {
+public:
+    // Touch point
+    struct TouchPoint {
+        int16_t x;
+        int16_t y;
+        uint16_t id;
+    };
+
+    // Destructor
+    virtual ~InputSource() {}
+
+    // Start the source (task is notified when input becomes available)
+    virtual void begin(TaskHandle_t task) = 0;
+
+    // Block until input may be available (returns false on timeout)
+    virtual bool waitForActivity(uint32_t timeoutMs) = 0;
+
+    // Sample current touch points (returns number of points)
+    virtual uint8_t read(TouchPoint* points, uint8_t maxCount) = 0;
+
+    // Get time of the last activity signal in microseconds since boot
+    virtual int64_t getLastActivityTimeUs() const = 0;
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <Print.h>
+#include <Stream.h>
+#include <atomic>
+#include <cstdint>
+#include "Clock.h"
+
+// Class for recording and replaying touch input and random draws
+//   Session messages and the replay summary go to the console. No Arduino
+//   dependencies beyond Print and Stream, so the host tests replay traces too.
+class InputTrace {
+public:
+    // Trace modes
+    enum class Mode : uint8_t {
+        IDLE,
+        RECORDING,
+        REPLAYING
+    };
+
+    // Record types
+    enum class RecordType : uint8_t {
+        TOUCH_PRESS,
+        TOUCH_MOVE,
+        TOUCH_RELEASE,
+        RANDOM,
+        FRAME_HASH
+    };
+
+    // Trace record (13 bytes, little-endian on the wire)
+    struct __attribute__((packed)) Record {
+        uint32_t timestampMs;   // milliseconds since the session started
+        uint32_t frame;         // frame index the record belongs to
+        uint8_t type;           // RecordType (low nibble) and finger index (high nibble)
+        union {
+            struct {
+                int16_t x;
+                int16_t y;
+            } touch;
+            uint32_t value;     // random value or frame hash
+        };
+    };
+
+    // Trace file header
+    struct __attribute__((packed)) Header {
+        char magic[4];          // "VTRC"
+        uint16_t version;
+        uint16_t recordSize;
+        uint32_t recordCount;
+    };
+
+    // Constructor (the clock stamps records and times replays)
+    InputTrace(Print& console, ClockFunction clock);
+
+    // Destructor
+    ~InputTrace();
+
+    // Allocate record buffer in PSRAM
+    bool initialize();
+
+    // Request a mode change (applied by the draw task at the next frame)
+    void requestRecording();
+    void requestReplay();
+    void requestStop();
+
+    // Apply pending mode change (returns true when a new session starts)
+    bool applyPendingMode();
+
+    // Get current mode
+    Mode getMode() const { return mode.load(); }
+
+    // Record touch event
+    void recordTouch(RecordType type, uint32_t frame, uint8_t finger, int16_t x, int16_t y);
+
+    // Record random draw
+    void recordRandom(uint32_t value);
+
+    // Record frame hash
+    void recordFrameHash(uint32_t frame, uint32_t hash);
+
+    // Get next touch event for the current frame (replay only)
+    bool nextTouch(RecordType& type, uint8_t& finger, int16_t& x, int16_t& y);
+
+    // Get next random draw (replay only)
+    bool nextRandom(uint32_t& value);
+
+    // Compare frame hash against the trace (replay only)
+    void checkFrameHash(uint32_t frame, uint32_t hash);
+
+    // Write trace in binary format
+    bool writeTo(Print& output) const;
+
+    // Read trace in binary format
+    bool readFrom(Stream& input);
+
+    // Get number of records
+    uint32_t getRecordCount() const { return recordCount; }
+
+    // Get results of the last replay
+    uint32_t getReplayedFrameCount() const { return replayedFrames; }
+    uint32_t getHashMismatchCount() const { return hashMismatches; }
+    uint32_t getRandomDivergenceCount() const { return randomDivergences; }
+
+private:
+    // Append a record
+    void append(RecordType type, uint32_t frame, uint32_t value, uint8_t finger = 0);
+
+    // Finish replay and print summary
+    void finishReplay();
+
+    // Get milliseconds from the clock
+    uint32_t getMillis() const { return static_cast<uint32_t>(clock() / 1000); }
+
+    // Output of session messages
+    Print& console;
+
+    // Monotonic clock
+    ClockFunction clock;
+
+    // Record buffer
+    Record* records = nullptr;
+    uint32_t recordCount = 0;
+
+    // Replay cursor
+    uint32_t replayCursor = 0;
+
+    // Session state
+    std::atomic<Mode> mode{Mode::IDLE};
+    std::atomic<Mode> pendingMode{Mode::IDLE};
+    std::atomic<bool> hasPendingMode{false};
+    uint32_t sessionStartMs = 0;
+    uint32_t currentFrame = 0;
+
+    // Replay statistics
+    uint32_t replayedFrames = 0;
+    uint32_t hashMismatches = 0;
+    uint32_t randomDivergences = 0;
+
+    // Trace format
+    static constexpr char MAGIC[4] = {'V', 'T', 'R', 'C'};
+    static constexpr uint16_t FORMAT_VERSION = 3U;
+
+    // Mask of the record type in the type field
+    static constexpr uint8_t TYPE_MASK = 0x0FU;
+
+    // Maximum number of records (about 420 KB in PSRAM)
+    static constexpr uint32_t MAX_RECORD_COUNT = 32768U;
+};
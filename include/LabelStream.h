@@ -0,0 +1,149 @@
+#pragma once
+
+#include <Print.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "Clock.h"
+#include "VoronoiCore.h"
+
+// Class for streaming run-length compressed label maps (for remote mirroring and capture)
+//   Every drawn frame is encoded as the seed table plus (length, label) runs per
+//   row. Delta packets only carry rows that changed since the last encoded
+//   frame; a keyframe with every row is sent periodically so that a decoder can
+//   join late or recover from a corrupted packet. Packets are written without
+//   blocking, and frames drawn while a packet is still being sent are skipped.
+//   A packet is written over several frames, so any other text printed on the
+//   same output in the meantime lands inside it; the decoder then drops that
+//   packet and waits for the next keyframe. No Arduino dependencies beyond
+//   Print, so the host tests encode to a file.
+class LabelStream {
+public:
+    // Packet flags
+    static constexpr uint8_t FLAG_KEYFRAME = 0x01U;
+
+    // Packet header (21 bytes, little-endian on the wire)
+    //   followed by seedCount seeds, rowCount rows and a 32-bit FNV-1a hash of the header
+//   fields after the magic and the payload
+    struct __attribute__((packed)) PacketHeader {
+        char magic[4];          // "VLRS"
+        uint8_t version;
+        uint8_t flags;          // FLAG_KEYFRAME
+        uint16_t width;
+        uint16_t height;
+        uint8_t seedCount;
+        uint32_t frame;         // frame index the label map belongs to
+        uint16_t rowCount;      // number of rows in the payload
+        uint32_t payloadSize;   // bytes between the header and the hash
+    };
+
+    // Seed table entry (6 bytes)
+    struct __attribute__((packed)) Seed {
+        int16_t x;
+        int16_t y;
+        uint16_t color;         // RGB565
+    };
+
+    // Row header (4 bytes), followed by runCount (length, label) byte pairs
+    struct __attribute__((packed)) RowHeader {
+        uint16_t y;
+        uint16_t runCount;
+    };
+
+    // Label of pixels without a seed
+    static constexpr uint8_t NO_SEED = 0xFFU;
+
+    // Constructor (the clock times the encoder for the statistics)
+    LabelStream(Print& output, ClockFunction clock);
+
+    // Destructor
+    ~LabelStream();
+
+    // Allocate packet and reference buffers (in PSRAM on the device)
+    bool initialize(int width, int height);
+
+    // Request start or stop (applied by the draw task at the next frame)
+    void requestStart();
+    void requestStop();
+
+    // Check if the stream is running
+    bool isStreaming() const { return isActive.load(); }
+
+    // Encode and send a frame (called from the draw task, labels may be nullptr for an empty screen)
+    void encodeFrame(uint32_t frame, const uint8_t* labels, const VoronoiCore::Point* points, std::size_t pointCount);
+
+    // Print and reset statistics
+    void printStatistics(Print& output);
+
+private:
+    // Append bytes to the packet (returns false if the packet buffer is full)
+    bool append(const void* data, std::size_t size);
+
+    // Append the runs of a row
+    bool appendRow(int y, const uint8_t* row);
+
+    // Check if a row differs from the reference
+    bool isRowChanged(const uint8_t* row, const uint8_t* reference) const;
+
+    // Check if the seed table differs from the reference
+    bool isSeedTableChanged(const VoronoiCore::Point* points, std::size_t count) const;
+
+    // Write as much of the pending packet as the output accepts without blocking
+    void sendPending();
+
+    // Output stream
+    Print& output;
+
+    // Clock for the encode time statistics
+    ClockFunction clock;
+
+    // Packet buffer
+    uint8_t* packet = nullptr;
+    std::size_t packetSize = 0;
+    std::size_t sentSize = 0;
+
+    // Label map of the last encoded frame
+    uint8_t* referenceLabels = nullptr;
+
+    // Seed table of the last encoded frame
+    Seed referenceSeeds[VoronoiCore::MAX_POINT_COUNT] = {};
+    std::size_t referenceSeedCount = 0;
+
+    // Row of pixels without a seed (used for an empty screen)
+    uint8_t* emptyRow = nullptr;
+
+    // Label map dimensions
+    int width = 0;
+    int height = 0;
+
+    // Stream state
+    std::atomic<bool> isActive{false};
+    std::atomic<bool> isStartRequested{false};
+    std::atomic<bool> isStopRequested{false};
+    bool isKeyframeNeeded = true;
+    uint32_t packetsSinceKeyframe = 0;
+
+    // Statistics
+    uint32_t packetCount = 0;
+    uint32_t keyframeCount = 0;
+    uint32_t unchangedFrameCount = 0;
+    uint32_t skippedFrameCount = 0;
+    uint32_t overflowCount = 0;
+    uint64_t totalBytes = 0;
+    uint32_t maxBytes = 0;
+    uint64_t totalEncodeUs = 0;
+    uint32_t maxEncodeUs = 0;
+
+    // Stream format
+    static constexpr char MAGIC[4] = {'V', 'L', 'R', 'S'};
+    static constexpr uint8_t FORMAT_VERSION = 2U;
+
+    // Longest run in a (length, label) pair
+    static constexpr int MAX_RUN_LENGTH = 255;
+
+    // Packets between keyframes
+    static constexpr uint32_t KEYFRAME_INTERVAL = 50U;
+
+    // Maximum packet size (a Voronoi row has at most a few runs per seed)
+    static constexpr std::size_t MAX_PACKET_SIZE = 16384U;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded lock-free multi-producer multi-consumer queue
+//   Each cell carries a sequence number that tells producers and consumers
+//   whether the cell is free or filled for their position, so push() and
+//   pop() never block and never allocate.
+template<typename T, std::size_t Capacity>
+class LockFreeQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Constructor
+    LockFreeQueue() {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Push an item (returns false if the queue is full)
+    bool push(const T& item) {
+        Cell* cell = nullptr;
+        std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &cells[pos & MASK];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->item = item;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pop an item (returns false if the queue is empty)
+    bool pop(T& item) {
+        Cell* cell = nullptr;
+        std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &cells[pos & MASK];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        item = cell->item;
+        cell->sequence.store(pos + MASK + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    // Queue cell
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T item;
+    };
+
+    // Index mask
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    // Cells
+    Cell cells[Capacity];
+
+    // Positions
+    std::atomic<std::size_t> enqueuePos{0};
+    std::atomic<std::size_t> dequeuePos{0};
+};
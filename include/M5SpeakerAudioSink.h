@@ -0,0 +1,32 @@
+#pragma once
+
+#include <M5Unified.h>
+#include <Arduino.h>
+#include "AudioSink.h"
+
+// Class for streaming mixed audio to the built-in speaker
+class M5SpeakerAudioSink : public AudioSink {
+public:
+    // Constructor
+    M5SpeakerAudioSink();
+
+    // Destructor
+    ~M5SpeakerAudioSink();
+
+    // Set the speaker volume
+    void begin() override;
+
+    // Block until the speaker channel has room for another buffer
+    void waitForRoom() override;
+
+    // Check if the speaker channel ran dry
+    bool isDrained() const override;
+
+    // Queue a buffer on the speaker channel (the buffer must stay valid while it plays)
+    bool write(const int16_t* samples, std::size_t count, uint32_t sampleRate) override;
+
+private:
+    // Speaker settings
+    static constexpr uint8_t DEFAULT_VOLUME = 48U;
+    static constexpr uint8_t SPEAKER_CHANNEL = 0U;
+};
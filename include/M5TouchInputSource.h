@@ -0,0 +1,43 @@
+#pragma once
+
+#include <M5Unified.h>
+#include <Arduino.h>
+#include "InputSource.h"
+
+// Class for reading the touch panel, woken by its interrupt line
+class M5TouchInputSource : public InputSource {
+public:
+    // Constructor
+    M5TouchInputSource();
+
+    // Destructor
+    ~M5TouchInputSource();
+
+    // Attach the touch interrupt
+    void begin(TaskHandle_t task) override;
+
+    // Block until the touch panel signals an interrupt
+    bool waitForActivity(uint32_t timeoutMs) override;
+
+    // Sample current touch points
+    uint8_t read(TouchPoint* points, uint8_t maxCount) override;
+
+    // Get time of the last touch interrupt
+    int64_t getLastActivityTimeUs() const override { return lastInterruptTimeUs; }
+
+private:
+    // Touch interrupt handler (static)
+    static void IRAM_ATTR handleInterrupt();
+
+    // Instance notified by the interrupt handler
+    static M5TouchInputSource* instance;
+
+    // Task to notify
+    TaskHandle_t notifyTask = nullptr;
+
+    // Time of the last touch interrupt
+    volatile int64_t lastInterruptTimeUs = 0;
+
+    // Touch panel interrupt pin (FT6336U INT on M5Stack Core2)
+    static constexpr uint8_t TOUCH_INT_PIN = 39U;
+};
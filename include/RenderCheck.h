@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "VoronoiCore.h"
+
+// Seed sets and label comparisons shared by the render self-test and the host tests
+//   Portable like VoronoiCore, so the device and the host check the same
+//   seeds against the same limits.
+class RenderCheck {
+public:
+    // Fixed seed set
+    struct SeedSet {
+        const char* name;
+        uint32_t seed;          // LCG seed (0 for the fixed corner set)
+        std::size_t count;
+    };
+
+    // Fixed seed sets (the last one fills the diagram)
+    static const SeedSet SEED_SETS[];
+    static const std::size_t SEED_SET_COUNT;
+
+    // Allowed ratio of JFA pixels assigned to a farther point
+    static constexpr float JFA_MAX_ERROR_RATIO = 0.001F;
+
+    // Offset of the simulated drag of the last point
+    static constexpr int DRAG_OFFSET_X = 17;
+    static constexpr int DRAG_OFFSET_Y = -11;
+
+    // Advance a linear congruential generator and return its upper 24 bits
+    static uint32_t nextRandom(uint32_t& state) {
+        state = state * 1664525U + 1013904223U;
+        return state >> 8;
+    }
+
+    // Generate points for a seed set on a width x height screen
+    static void generatePoints(const SeedSet& set, int width, int height, std::vector<VoronoiCore::Point>& out);
+
+    // Move the last point by the drag offset, clamped to the screen
+    static void dragLastPoint(std::vector<VoronoiCore::Point>& points, int width, int height);
+
+    // Count pixels whose label differs from the reference and whose assigned point is farther than the nearest one
+    static void compareLabels(const VoronoiCore::Point* seeds, std::size_t count, int width, int height,
+                              const int16_t* reference, const int16_t* actual,
+                              uint32_t& labelMismatches, uint32_t& distanceMismatches);
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <vector>
+#include "RenderCheck.h"
+#include "VoronoiDiagram.h"
+
+// Class for comparing render paths against the exact brute-force label map
+//   Timings are checked against baselines stored in NVS by an earlier run on
+//   the same device, so a path fails only if it got slower than it used to be.
+class RenderSelfTest {
+public:
+    // Constructor
+    RenderSelfTest(VoronoiDiagram& voronoi);
+
+    // Run all seed sets through all render paths (returns true if every check passes)
+    //   Missing baselines are recorded; all of them are re-recorded if updateBaselines is set.
+    bool run(Print& output, bool updateBaselines = false);
+
+private:
+    // Render path under test
+    struct PathSpec {
+        VoronoiDiagram::RenderPath path;
+        const char* name;
+        float maxErrorRatio;    // allowed ratio of pixels assigned to a farther point
+    };
+
+    // Render labels through a path (returns false if the path is not available)
+    bool renderPath(const PathSpec& spec, const std::vector<VoronoiDiagram::Point>& seeds, int64_t& micros);
+
+    // Check a timing against its stored baseline (records the timing if there is none)
+    //   Returns the result column text; isFastEnough is false on a regression.
+    const char* checkBaseline(std::size_t setIndex, std::size_t pathIndex, int64_t micros,
+                              bool updateBaselines, uint32_t& baselineMicros, bool& isFastEnough);
+
+    // Voronoi diagram
+    VoronoiDiagram& voronoiDiagram;
+
+    // Stored timing baselines
+    Preferences baselines;
+
+    // Points before the simulated drag (used by the incremental path)
+    std::vector<VoronoiDiagram::Point> previousSeeds;
+
+    // Reference and candidate label maps
+    int16_t* referenceLabels = nullptr;
+    int16_t* candidateLabels = nullptr;
+
+    // Render paths under test
+    static const PathSpec PATHS[];
+
+    // Number of timed runs per path (the fastest one is reported)
+    static constexpr int TIMING_RUN_COUNT = 3;
+
+    // Allowed time relative to the stored baseline (plus a fixed slack for short timings)
+    static constexpr float BASELINE_TOLERANCE = 1.25F;
+    static constexpr int64_t BASELINE_SLACK_US = 200;
+};
@@ -1,39 +1,85 @@
 #pragma once
 
-#include <M5Unified.h>
 #include <Arduino.h>
+#include "LockFreeQueue.h"
+#include "AudioMixer.h"
+#include "AudioSink.h"
+#include "SoundPlayer.h"
 
 // Class for managing sound effects
-class SoundManager {
+//   Callers only enqueue a small command; an audio task mixes wavetable
+//   voices and streams the result to an audio sink.
+class SoundManager : public SoundPlayer {
 public:
-    // Sound types
-    enum class SoundType {
-        TOUCH,
-        STARTUP
-    };
-
     // Constructor
-    SoundManager();
+    explicit SoundManager(AudioSink& sink);
+
+    // Destructor
+    ~SoundManager();
 
-    // Initialize sound system
+    // Initialize sound system and start the audio task
     void initialize();
 
-    // Play a sound effect
-    void playSound(SoundType type);
+    // Play a sound effect (returns immediately)
+    void playSound(SoundType type) override;
 
-    // Play startup sequence
+    // Play startup sequence (returns immediately)
     void playStartupSequence();
 
+    // Print and reset audio statistics
+    void printStatistics(Print& output);
+
 private:
-    // Sound settings
-    static constexpr uint8_t DEFAULT_VOLUME = 48U;
-    
+    // Command passed to the audio task
+    struct SoundCommand {
+        float frequency;
+        uint16_t durationMs;
+        uint16_t delayMs;
+    };
+
+    // Enqueue a tone
+    void enqueueTone(float frequency, uint32_t durationMs, uint32_t delayMs);
+
+    // Audio task function (static)
+    static void audioTaskFunction(void* args);
+
     // Touch feedback sound settings
     static constexpr float TOUCH_FREQUENCY = 659.26F;
     static constexpr uint32_t TOUCH_DURATION = 50U;
+
+    // Eviction sound settings
+    static constexpr float EVICTION_FREQUENCY = 329.63F;
+    static constexpr uint32_t EVICTION_DURATION = 40U;
     
     // Startup sound settings
     static constexpr float STARTUP_FREQUENCY = 659.26F;
     static constexpr uint32_t STARTUP_DURATION = 50U;
     static constexpr uint32_t STARTUP_DELAY = 150U;
+
+    // Streaming buffers (one playing, one queued, one being mixed)
+    static constexpr std::size_t BUFFER_COUNT = 3U;
+
+    // Audio task settings
+    static constexpr uint32_t AUDIO_TASK_STACK_SIZE = 3072U;
+
+    // Command queue
+    LockFreeQueue<SoundCommand, 16> commandQueue;
+
+    // Audio task handle
+    TaskHandle_t audioTaskHandle = nullptr;
+
+    // Destination of the mixed audio
+    AudioSink& audioSink;
+
+    // Mixer (touched only by the audio task)
+    AudioMixer mixer;
+
+    // Streaming buffers
+    int16_t buffers[BUFFER_COUNT][AudioMixer::BUFFER_SAMPLES] = {};
+    std::size_t nextBufferIndex = 0;
+
+    // Statistics
+    std::atomic<uint32_t> droppedCommandCount{0};
+    std::atomic<uint32_t> underrunCount{0};
+    std::atomic<uint32_t> mixedBufferCount{0};
 };
@@ -0,0 +1,19 @@
+#pragma once
+
+// Interface for players of sound effects
+//   SoundManager plays them on the device; host tests count them.
+class SoundPlayer {
+public:
+    // Sound types
+    enum class SoundType {
+        TOUCH,
+        STARTUP,
+        EVICTION
+    };
+
+    // Destructor
+    virtual ~SoundPlayer() {}
+
+    // Play a sound effect (returns immediately)
+    virtual void playSound(SoundType type) = 0;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "InputSource.h"
+#include "Clock.h"
+
+// Class for generating scripted taps and drags without touching the panel
+//   Strokes cover the given screen area and are timed by the given clock, so
+//   the host tests drive the same script with a clock they advance themselves.
+class SyntheticInputSource : public InputSource {
+public:
+    // Constructor
+    SyntheticInputSource(int width, int height, ClockFunction clock, uint32_t seed = 1U);
+
+    // Start the script
+    void begin(TaskHandle_t task) override;
+
+    // Sleep until the next stroke starts (host builds do not sleep and only report whether it has started)
+    bool waitForActivity(uint32_t timeoutMs) override;
+
+    // Sample the scripted touch point
+    uint8_t read(TouchPoint* points, uint8_t maxCount) override;
+
+    // Get start time of the current stroke
+    int64_t getLastActivityTimeUs() const override { return strokeStartUs; }
+
+private:
+    // Advance to the next stroke
+    void nextStroke();
+
+    // Next value of the linear congruential generator
+    uint32_t nextRandom();
+
+    // Screen dimensions
+    int screenWidth = 1;
+    int screenHeight = 1;
+
+    // Monotonic clock
+    ClockFunction clock;
+
+    // Generator state
+    uint32_t randomState;
+
+    // Current stroke
+    int64_t strokeStartUs = 0;
+    uint32_t strokeDurationMs = 0;
+    int16_t startX = 0;
+    int16_t startY = 0;
+    int16_t endX = 0;
+    int16_t endY = 0;
+    uint16_t strokeId = 0;
+
+    // Stroke timing
+    static constexpr uint32_t STROKE_INTERVAL_MS = 800U;
+    static constexpr uint32_t TAP_DURATION_MS = 60U;
+    static constexpr uint32_t DRAG_DURATION_MS = 400U;
+};
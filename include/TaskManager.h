@@ -1,15 +1,20 @@
 #pragma once
 
 #include <Arduino.h>
+#include <atomic>
 #include "VoronoiDiagram.h"
 #include "TouchHandler.h"
 #include "SoundManager.h"
+#include "BootProfiler.h"
+#include "HeapMonitor.h"
+#include "InputSource.h"
 
 // Class for managing FreeRTOS tasks
 class TaskManager {
 public:
     // Constructor
-    TaskManager(VoronoiDiagram& voronoi, TouchHandler& touch);
+    TaskManager(VoronoiDiagram& voronoi, TouchHandler& touch, InputSource& input, BootProfiler& profiler,
+                HeapMonitor& heap);
 
     // Destructor
     ~TaskManager();
@@ -20,6 +25,13 @@ public:
     // Create mutex for drawing
     SemaphoreHandle_t createDrawMutex();
 
+    // Switch between event-driven input sampling and fixed 1 ms polling
+    void setPollingMode(bool enabled) { isPollingMode.store(enabled); }
+    bool getPollingMode() const { return isPollingMode.load(); }
+
+    // Print and reset input sampling statistics
+    void printStatistics(Print& output);
+
 private:
     // Voronoi diagram
     VoronoiDiagram& voronoiDiagram;
@@ -27,6 +39,15 @@ private:
     // Touch handler
     TouchHandler& touchHandler;
 
+    // Source of touch input
+    InputSource& inputSource;
+
+    // Boot profiler
+    BootProfiler& bootProfiler;
+
+    // Heap monitor
+    HeapMonitor& heapMonitor;
+
     // Task handles
     TaskHandle_t touchTaskHandle = nullptr;
     TaskHandle_t drawTaskHandle = nullptr;
@@ -34,6 +55,24 @@ private:
     // Mutex for drawing
     SemaphoreHandle_t drawMutex = nullptr;
 
+    // Input sampling mode
+    std::atomic<bool> isPollingMode{false};
+
+    // Input sampling statistics
+    std::atomic<uint32_t> wakeupCount{0};
+    std::atomic<uint32_t> touchStartCount{0};
+    std::atomic<uint32_t> totalLatencyUs{0};
+    std::atomic<uint32_t> maxLatencyUs{0};
+    int64_t statisticsStartUs = 0;
+
+    // Input sampling intervals
+    static constexpr uint32_t MIN_POLL_INTERVAL_MS = 4U;     // while the finger moves
+    static constexpr uint32_t MAX_POLL_INTERVAL_MS = 32U;    // while the finger rests
+    static constexpr uint32_t IDLE_TIMEOUT_MS = 1000U;       // safety wakeup without interrupt
+
+    // Frames allowed to allocate before the heap check starts
+    static constexpr uint32_t HEAP_WARMUP_FRAMES = 100U;
+
     // Main task function (static)
     static void touchTaskFunction(void* args);
 
@@ -1,29 +1,135 @@
 #pragma once
 
-#include <M5Unified.h>
-#include <Arduino.h>
-#include "VoronoiDiagram.h"
-#include "SoundManager.h"
+#include <Print.h>
+#include "VoronoiModel.h"
+#include "SoundPlayer.h"
+#include "InputTrace.h"
+#include "InputSource.h"
+#include "LockFreeQueue.h"
+#include <atomic>
 
 // Class for handling touch input
+//   Presses and releases are queued and never dropped. Moves are coalesced on
+//   the touch task: each finger keeps only its latest position, and the draw
+//   task picks it up once per frame. No Arduino dependencies beyond Print, so
+//   the host tests feed and replay input through the same code.
 class TouchHandler {
 public:
     // Constructor
-    TouchHandler(VoronoiDiagram& voronoi, SoundManager& sound);
+    TouchHandler(VoronoiModel& voronoi, SoundPlayer& sound, InputTrace& trace, InputSource& input);
 
-    // Process touch input
-    void handleInput();
+    // Sample touch input, queue presses and releases, and publish moves (called from the touch task)
+    // Returns number of queued or published events
+    uint32_t handleInput();
+
+    // Check if any finger is on the panel (called from the touch task)
+    bool hasActiveTouch() const;
+
+    // Apply queued or replayed touch events (called from the draw task before drawing)
+    void processEvents();
+
+    // Record or verify the frame just drawn (called from the draw task after drawing)
+    void finishFrame();
+
+    // Print and reset event batch statistics
+    void printStatistics(Print& output);
 
 private:
-    // Voronoi diagram
-    VoronoiDiagram& voronoiDiagram;
+    // Touch event passed from the touch task to the draw task
+    //   Releases carry the last sampled position of the finger.
+    struct TouchEvent {
+        InputTrace::RecordType type;
+        uint8_t finger;
+        uint8_t generation;     // touch generation of the finger (see SampledFinger)
+        int16_t x;
+        int16_t y;
+    };
+
+    // Touch state of a finger on the sampling side
+    struct SampledFinger {
+        bool isActive;
+        uint16_t id;
+        uint8_t generation;     // incremented on every press, so moves of an earlier touch can be told apart
+        int16_t x;
+        int16_t y;
+    };
+
+    // Touch state of a finger on the processing side
+    struct FingerState {
+        bool isActive;
+        bool isDragging;
+        uint8_t generation;
+        int16_t initialX;
+        int16_t initialY;
+        int pointIndex;     // dragged point (-1 if none)
+    };
+
+    // Queue a press or release (returns false if the queue is full)
+    bool queueEvent(InputTrace::RecordType type, uint8_t finger, uint8_t generation, int16_t x, int16_t y);
+
+    // Pack and unpack the latest position of a finger
+    //   Bit 31 marks a pending move, bits 30-24 hold the generation, and bits
+    //   23-12 and 11-0 hold x and y.
+    static uint32_t packMove(uint8_t generation, int16_t x, int16_t y);
+    static void unpackMove(uint32_t packed, uint8_t& generation, int16_t& x, int16_t& y);
+
+    // Apply and record a touch event
+    void applyAndRecord(const TouchEvent& event, uint32_t frame);
+
+    // Apply a touch event to the Voronoi model
+    void applyEvent(const TouchEvent& event);
+
+    // Add a point and fix up indices of dragged points
+    void addPoint(int x, int y);
+
+    // Reset finger states on the processing side
+    void resetFingers();
+
+    // Voronoi model (touched only by the draw task)
+    VoronoiModel& voronoiModel;
     
-    // Sound manager
-    SoundManager& soundManager;
+    // Sound effects
+    SoundPlayer& soundPlayer;
+
+    // Input trace
+    InputTrace& inputTrace;
+
+    // Source of touch input
+    InputSource& inputSource;
 
-    // Initial touch position (set to invalid coordinates)
-    m5::touch_detail_t initialTouchPosition = {};
+    // Maximum number of simultaneous touch points
+    static constexpr uint8_t MAX_FINGER_COUNT = 3U;
+
+    // Event queue length
+    static constexpr std::size_t EVENT_QUEUE_LENGTH = 32U;
+
+    // Queue of touch events (touch task to draw task)
+    LockFreeQueue<TouchEvent, EVENT_QUEUE_LENGTH> eventQueue;
 
     // Drag threshold
     static constexpr int DRAG_THRESHOLD = 10;
+
+    // Finger states on the sampling side (touch task)
+    SampledFinger sampledFingers[MAX_FINGER_COUNT] = {};
+
+    // Latest unconsumed position per finger (written by the touch task, taken by the draw task)
+    std::atomic<uint32_t> latestMoves[MAX_FINGER_COUNT];
+
+    // Empty latest position
+    static constexpr uint32_t NO_MOVE = 0U;
+
+    // Finger states on the processing side (draw task)
+    FingerState fingers[MAX_FINGER_COUNT] = {};
+
+    // Events received in the current frame
+    TouchEvent eventBatch[EVENT_QUEUE_LENGTH] = {};
+    std::size_t eventBatchSize = 0;
+
+    // Event batch statistics (updated by the draw and touch tasks, read and reset by the loop task)
+    std::atomic<uint32_t> batchFrameCount{0};
+    std::atomic<uint32_t> receivedEventCount{0};
+    std::atomic<uint32_t> appliedMoveCount{0};
+    std::atomic<uint32_t> maxBatchSize{0};
+    std::atomic<uint32_t> sampledMoveCount{0};
+    std::atomic<uint32_t> deferredEventCount{0};
 };
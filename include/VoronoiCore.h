@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <climits>
+
+// Portable Voronoi label math (no Arduino dependencies, also built by the host tests)
+//   Every function works on a const span of points passed by the caller, so
+//   the same code labels the live diagram and arbitrary test seed sets.
+class VoronoiCore {
+public:
+    // Point structure
+    struct Point {
+        int x;
+        int y;
+        uint16_t color;
+    };
+
+    // Seed point structure for Jump Flooding Algorithm
+    struct SeedPoint {
+        int16_t x;      // x-coordinate
+        int16_t y;      // y-coordinate
+        int16_t idx;    // index of the original point
+    };
+
+    // Repulsive force acting on a point
+    struct Force {
+        float x;
+        float y;
+    };
+
+    // Maximum number of points handled by the incremental update (bits of the moved mask)
+    static constexpr std::size_t MAX_POINT_COUNT = 32U;
+
+    // Repulsion force parameters
+    static constexpr float REPULSION_STRENGTH = 15000.0F;
+    static constexpr float REPULSION_RADIUS = 150.0F;
+
+    // Push points apart within the repulsion radius and clamp them to [0, maxX] x [0, maxY]
+    //   Pinned points (bit per index) stay put; forces is scratch memory for count entries.
+    static void applyRepulsiveForce(Point* points, std::size_t count, uint32_t pinnedMask,
+                                    int maxX, int maxY, Force* forces);
+
+    // Get index of the nearest point (lowest index wins ties, -1 if there are no points)
+    static int getNearestPointIndex(const Point* points, std::size_t count, int x, int y);
+
+    // Label every pixel with the nearest point (exact)
+    template<typename Label, typename Paint>
+    static void computeBruteForce(const Point* points, std::size_t count, int width, int height,
+                                  Label* labels, Paint paint) {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                const int nearestIndex = getNearestPointIndex(points, count, x, y);
+                labels[y * width + x] = static_cast<Label>(nearestIndex);
+                if (nearestIndex >= 0) {
+                    paint(x, y, nearestIndex);
+                }
+            }
+        }
+    }
+
+    // Execute Jump Flooding Algorithm (approximate, result in bufferA)
+    static void executeJFA(const Point* points, std::size_t count, int width, int height,
+                           SeedPoint* bufferA, SeedPoint* bufferB);
+
+    // Get mask of points moved against the previous positions
+    static uint32_t getMovedPointMask(const Point* points, const Point* previous, std::size_t count);
+
+    // Relabel pixels affected by the moved points (returns number of changed pixels)
+    //   Pixels in a moved point's cell are searched again over all points; every
+    //   other pixel can only switch to one of the moved points. Ties go to the
+    //   lower index, as in getNearestPointIndex().
+    template<typename Label, typename Paint>
+    static uint32_t updateMovedLabels(const Point* points, std::size_t count, uint32_t movedMask,
+                                      int width, int height, Label* labels, Paint paint) {
+        if (movedMask == 0) {
+            return 0;
+        }
+
+        const int numPoints = static_cast<int>(count);
+
+        // Collect indices of the moved points
+        int movedIndices[MAX_POINT_COUNT];
+        int movedCount = 0;
+        for (int i = 0; i < numPoints; ++i) {
+            if (movedMask & (1U << i)) {
+                movedIndices[movedCount++] = i;
+            }
+        }
+
+        uint32_t changedCount = 0;
+
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                const int idx = y * width + x;
+                const int label = labels[idx];
+                int nearestIndex;
+
+                if (label < 0 || label >= numPoints || (movedMask & (1U << label))) {
+                    // Cell of a moved point (or unassigned pixel)
+                    nearestIndex = getNearestPointIndex(points, count, x, y);
+                } else {
+                    // Check only the moved points against the current label
+                    nearestIndex = label;
+                    int dx = x - points[label].x;
+                    int dy = y - points[label].y;
+                    int nearestDistSquared = dx * dx + dy * dy;
+
+                    for (int k = 0; k < movedCount; ++k) {
+                        const int i = movedIndices[k];
+                        dx = x - points[i].x;
+                        dy = y - points[i].y;
+                        const int distSquared = dx * dx + dy * dy;
+
+                        if (distSquared < nearestDistSquared || (distSquared == nearestDistSquared && i < nearestIndex)) {
+                            nearestDistSquared = distSquared;
+                            nearestIndex = i;
+                        }
+                    }
+                }
+
+                if (nearestIndex != label) {
+                    labels[idx] = static_cast<Label>(nearestIndex);
+                    ++changedCount;
+                    paint(x, y, nearestIndex);
+                }
+            }
+        }
+
+        return changedCount;
+    }
+
+    // Paint callback that does nothing (label maps only)
+    struct NoPaint {
+        void operator()(int, int, int) const {}
+    };
+};
@@ -5,62 +5,68 @@
 #include <vector>
 #include <cmath>
 #include <memory>
-#include <esp_heap_caps.h>
 #include <algorithm>
+#include "VoronoiModel.h"
+
+class LabelStream;
 
 // Class for managing Voronoi diagram
+//   The points and label map live in a VoronoiModel, edited by the touch
+//   handler; this class paints every frame step of the model onto the screen.
 class VoronoiDiagram {
 public:
     // Point structure
-    struct Point {
-        int x;
-        int y;
-        uint16_t color;
-    };
-
-    // Seed point structure for Jump Flooding Algorithm
-    struct SeedPoint {
-        int16_t x;      // x-coordinate
-        int16_t y;      // y-coordinate
-        int16_t idx;    // index of the original point
-    };
+    using Point = VoronoiModel::Point;
+
+    // Render paths used to compute the label map
+    using RenderPath = VoronoiModel::RenderPath;
+
+    // Maximum number of points
+    static constexpr std::size_t MAX_POINT_COUNT = VoronoiModel::MAX_POINT_COUNT;
 
     // Constructor
-    VoronoiDiagram(M5Canvas& buffer, SemaphoreHandle_t mutex);
-    
-    // Destructor
-    ~VoronoiDiagram();
+    VoronoiDiagram(VoronoiModel& voronoiModel, M5Canvas& buffer, SemaphoreHandle_t mutex);
 
-    // Add a point
-    void addPoint(int x, int y);
+    // Allocate JFA buffers and label map (call once after the first frame is shown)
+    void allocateBuffers();
 
     // Draw Voronoi diagram
     void draw();
 
-private:
-    // Apply repulsive force to move points
-    void applyRepulsiveForce();
-
-    // Render Voronoi diagram using Jump Flooding Algorithm
-    void renderVoronoiDiagram();
-    
-    // Initialize JFA buffers in internal SRAM (with fallback to PSRAM)
-    void initJFABuffers();
-    
-    // Free JFA buffers
-    void freeJFABuffers();
-    
-    // Execute Jump Flooding Algorithm
-    void executeJFA();
+    // Remove all points and clear the screen
+    void clear();
+
+    // Set label stream for mirroring drawn frames
+    void setLabelStream(LabelStream* stream) { labelStream = stream; }
+
+    // Get number of frames drawn
+    uint32_t getFrameCount() const { return model.getFrameCount(); }
 
+    // Compute label map (nearest point index per pixel) for the given points
+    //   The model's own points are left alone; only the JFA buffers are shared.
+    bool computeLabels(const Point* seeds, std::size_t count, RenderPath path, int16_t* labels);
+
+    // Update a label map computed for the previous points to the given points
+    bool updateLabels(const Point* previous, const Point* seeds, std::size_t count, int16_t* labels) const {
+        return model.updateLabels(previous, seeds, count, labels);
+    }
+
+    // Get per-frame scratch arena (for statistics)
+    const FrameArena& getFrameArena() const { return model.getFrameArena(); }
+
+    // Get screen dimensions
+    int getWidth() const { return model.getWidth(); }
+    int getHeight() const { return model.getHeight(); }
+
+private:
     // Render points
     void renderPoints();
 
-    // Get index of the nearest point (used as fallback)
-    int getNearestPointIndex(int x, int y) const;
+    // Repaint the areas under the previously drawn point circles
+    void repaintPreviousPoints();
 
-    // List of points
-    std::vector<Point> points;
+    // Points, label map and frame step
+    VoronoiModel& model;
 
     // Drawing buffer
     M5Canvas& screenBuffer;
@@ -68,22 +74,13 @@ private:
     // Mutex for drawing
     SemaphoreHandle_t drawMutex;
 
-    // JFA buffers (allocated in internal SRAM when possible, with fallback to PSRAM)
-    SeedPoint* jfaBufferA = nullptr;
-    SeedPoint* jfaBufferB = nullptr;
-    
-    // Screen dimensions
-    int screenWidth = 0;
-    int screenHeight = 0;
-    int screenSize = 0;  // width * height
-
-    // Maximum number of points
-    static constexpr std::size_t MAX_POINT_COUNT = 16U;
+    // Label stream (optional)
+    LabelStream* labelStream = nullptr;
 
-    // Repulsion force parameters
-    static constexpr float REPULSION_STRENGTH = 15000.0F;
-    static constexpr float REPULSION_RADIUS = 150.0F;
+    // Positions of the point circles drawn in the last frame
+    Point drawnPoints[MAX_POINT_COUNT];
+    std::size_t drawnPointCount = 0;
 
-    // Color palette (20 pastel colors) - RGB565 format
-    static const uint16_t COLOR_PALETTE[20];
+    // Radius of the point circles
+    static constexpr int POINT_RADIUS = 3;
 };
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "FrameArena.h"
+#include "VoronoiCore.h"
+
+class InputTrace;
+
+// Class for the portable state and frame step of the Voronoi diagram
+//   Holds the points, the label map and the JFA buffers. step() moves the
+//   points and relabels the pixels, reporting every relabeled pixel to a
+//   paint callback: VoronoiDiagram paints them onto the screen, the host
+//   tests run the same step without a screen. Point colors come from an
+//   injected random source, recorded or replayed through the input trace.
+class VoronoiModel {
+public:
+    // Point structure
+    using Point = VoronoiCore::Point;
+
+    // Seed point structure for Jump Flooding Algorithm
+    using SeedPoint = VoronoiCore::SeedPoint;
+
+    // Render paths used to compute the label map
+    enum class RenderPath : uint8_t {
+        BRUTE_FORCE,    // nearest point search for every pixel (exact)
+        JFA,            // Jump Flooding Algorithm (approximate)
+        INCREMENTAL     // update of an existing label map for moved points
+    };
+
+    // How a frame step updated the label map
+    enum class StepResult : uint8_t {
+        EMPTY,          // no points (nothing relabeled)
+        INCREMENTAL,    // only pixels affected by moved points were relabeled
+        FULL            // every pixel was relabeled
+    };
+
+    // Maximum number of points
+    static constexpr std::size_t MAX_POINT_COUNT = 16U;
+
+    // Invalid label in the label map
+    static constexpr uint8_t INVALID_LABEL = 0xFFU;
+
+    // Source of random values (esp_random on the device)
+    typedef uint32_t (*RandomFunction)();
+
+    // Constructor
+    VoronoiModel(int width, int height, RandomFunction random);
+
+    // Destructor
+    ~VoronoiModel();
+
+    // Allocate JFA buffers and label map (returns false if the label map could not be allocated)
+    bool allocateBuffers();
+
+    // Add a point with a random palette color (returns true if the oldest point was removed to make room)
+    bool addPoint(int x, int y);
+
+    // Get index of the point whose cell contains the position (O(1) lookup in the label map)
+    int findPointAt(int x, int y) const;
+
+    // Move a point and pin it against the repulsive force
+    void movePoint(int index, int x, int y);
+
+    // Release a pinned point
+    void releasePoint(int index);
+
+    // Release every pinned point
+    void releaseAllPoints() { pinnedMask = 0; }
+
+    // Remove all points
+    void clear();
+
+    // Set input trace for recording or replaying random draws
+    void setInputTrace(InputTrace* trace) { inputTrace = trace; }
+
+    // Compute hash of the label map and the points (identical on the device and the host)
+    uint32_t computeFrameHash() const;
+
+    // Run one frame: reset the frame arena, apply the repulsive force and relabel the pixels
+    //   paint(x, y, index) is called for every pixel whose label changed (every pixel on a full relabel).
+    template<typename Paint>
+    StepResult step(Paint paint);
+
+    // Compute label map (nearest point index per pixel) for the given points
+    //   The model's own points are left alone; only the JFA buffers are shared.
+    bool computeLabels(const Point* seeds, std::size_t count, RenderPath path, int16_t* labels);
+
+    // Update a label map computed for the previous points to the given points
+    bool updateLabels(const Point* previous, const Point* seeds, std::size_t count, int16_t* labels) const;
+
+    // Get points
+    const Point* getPoints() const { return points.data(); }
+    std::size_t getPointCount() const { return points.size(); }
+
+    // Get label map of the last step (nullptr until a step has labeled the current points)
+    const uint8_t* getLabelMap() const { return isLabelMapValid ? labelMap : nullptr; }
+
+    // Get points pinned by dragging (bit per point index)
+    uint32_t getPinnedMask() const { return pinnedMask; }
+
+    // Get number of frames stepped
+    uint32_t getFrameCount() const { return frameCount; }
+
+    // Get per-frame scratch arena (for statistics)
+    const FrameArena& getFrameArena() const { return frameArena; }
+
+    // Get screen dimensions
+    int getWidth() const { return screenWidth; }
+    int getHeight() const { return screenHeight; }
+
+private:
+    // Size of the per-frame scratch arena
+    static constexpr std::size_t FRAME_ARENA_SIZE = 1024U;
+
+    // Draw a random value (recorded or replayed through the input trace)
+    uint32_t nextRandom();
+
+    // Apply repulsive force to move points
+    void applyRepulsiveForce();
+
+    // Free JFA buffers and label map
+    void freeBuffers();
+
+    // Get index of the nearest point (used as fallback)
+    int getNearestPointIndex(int x, int y) const {
+        return VoronoiCore::getNearestPointIndex(points.data(), points.size(), x, y);
+    }
+
+    // List of points (capacity reserved up front, so it never reallocates)
+    std::vector<Point> points;
+
+    // Scratch memory for the current frame (reset at the start of every step)
+    FrameArena frameArena{FRAME_ARENA_SIZE};
+
+    // Number of frames stepped
+    uint32_t frameCount = 0;
+
+    // Source of random values
+    RandomFunction random;
+
+    // Input trace (optional)
+    InputTrace* inputTrace = nullptr;
+
+    // JFA buffers (allocated in internal SRAM when possible, with fallback to PSRAM)
+    SeedPoint* jfaBufferA = nullptr;
+    SeedPoint* jfaBufferB = nullptr;
+
+    // Label map of the last step (point index per pixel)
+    uint8_t* labelMap = nullptr;
+    bool isLabelMapValid = false;
+
+    // Point positions the label map was computed for
+    Point labelPoints[MAX_POINT_COUNT];
+    std::size_t labelPointCount = 0;
+
+    // Points pinned by dragging (bit per point index)
+    uint32_t pinnedMask = 0;
+
+    // Screen dimensions
+    int screenWidth = 0;
+    int screenHeight = 0;
+    int screenSize = 0;  // width * height
+
+    // Color palette (20 pastel colors) - RGB565 format
+    static const uint16_t COLOR_PALETTE[20];
+};
+
+// Run one frame
+template<typename Paint>
+VoronoiModel::StepResult VoronoiModel::step(Paint paint) {
+    // Count every frame so that replayed input lines up with the recording
+    ++frameCount;
+
+    // Release scratch memory of the previous frame
+    frameArena.reset();
+
+    const std::size_t numPoints = points.size();
+    if (numPoints == 0) {
+        return StepResult::EMPTY;
+    }
+
+    // Apply repulsive force to move points
+    applyRepulsiveForce();
+
+    // Update only the pixels affected by moved points while most points stay still
+    if (labelMap && isLabelMapValid && labelPointCount == numPoints) {
+        const uint32_t movedMask = VoronoiCore::getMovedPointMask(points.data(), labelPoints, numPoints);
+        const std::size_t movedCount = __builtin_popcount(movedMask);
+
+        if (movedCount * 2 <= numPoints) {
+            VoronoiCore::updateMovedLabels(points.data(), numPoints, movedMask, screenWidth, screenHeight, labelMap,
+                                           paint);
+            for (std::size_t i = 0; i < numPoints; ++i) {
+                labelPoints[i] = points[i];
+            }
+            return StepResult::INCREMENTAL;
+        }
+    }
+
+    if (!jfaBufferA || !jfaBufferB) {
+        // Fallback to traditional method if buffers are not available
+        for (int y = 0; y < screenHeight; ++y) {
+            for (int x = 0; x < screenWidth; ++x) {
+                const int nearestIndex = getNearestPointIndex(x, y);
+                paint(x, y, nearestIndex);
+                if (labelMap) {
+                    labelMap[y * screenWidth + x] = static_cast<uint8_t>(nearestIndex);
+                }
+            }
+        }
+    } else {
+        // Execute Jump Flooding Algorithm
+        VoronoiCore::executeJFA(points.data(), numPoints, screenWidth, screenHeight, jfaBufferA, jfaBufferB);
+
+        for (int y = 0; y < screenHeight; ++y) {
+            for (int x = 0; x < screenWidth; ++x) {
+                const int idx = y * screenWidth + x;
+                const int pointIdx = jfaBufferA[idx].idx;
+                const bool isValidIndex = (pointIdx >= 0 && pointIdx < static_cast<int>(numPoints));
+
+                if (isValidIndex) {
+                    paint(x, y, pointIdx);
+                }
+                if (labelMap) {
+                    labelMap[idx] = isValidIndex ? pointIdx : INVALID_LABEL;
+                }
+            }
+        }
+    }
+
+    // Remember the points the label map was computed for
+    for (std::size_t i = 0; i < numPoints; ++i) {
+        labelPoints[i] = points[i];
+    }
+    labelPointCount = numPoints;
+    isLabelMapValid = (labelMap != nullptr);
+
+    return StepResult::FULL;
+}
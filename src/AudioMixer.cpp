@@ -0,0 +1,105 @@
+#include "AudioMixer.h"
+#include <algorithm>
+#include <cmath>
+
+// Out-of-class definitions (odr-used by callers that take references)
+constexpr uint32_t AudioMixer::SAMPLE_RATE;
+constexpr std::size_t AudioMixer::BUFFER_SAMPLES;
+constexpr std::size_t AudioMixer::MAX_VOICE_COUNT;
+constexpr int16_t AudioMixer::WAVETABLE_AMPLITUDE;
+
+// Constructor
+AudioMixer::AudioMixer() {
+    // Precompute one period of a sine wave
+    for (std::size_t i = 0; i < WAVETABLE_SIZE; ++i) {
+        const float angle = 2.0F * static_cast<float>(M_PI) * i / WAVETABLE_SIZE;
+        wavetable[i] = static_cast<int16_t>(WAVETABLE_AMPLITUDE * sinf(angle));
+    }
+}
+
+// Start a tone after the given delay
+void AudioMixer::startTone(float frequency, uint32_t durationMs, uint32_t delayMs) {
+    Voice* target = nullptr;
+
+    for (Voice& voice : voices) {
+        // Use a free voice
+        if (!voice.isActive) {
+            target = &voice;
+            break;
+        }
+
+        // Otherwise steal the voice closest to its end
+        if (target == nullptr || voice.remainingSamples < target->remainingSamples) {
+            target = &voice;
+        }
+    }
+
+    target->isActive = true;
+    target->phase = 0U;
+    target->phaseIncrement = static_cast<uint32_t>(frequency * 4294967296.0 / SAMPLE_RATE);
+    target->delaySamples = delayMs * SAMPLE_RATE / 1000U;
+    target->elapsedSamples = 0U;
+    target->remainingSamples = durationMs * SAMPLE_RATE / 1000U;
+
+    // A zero-length tone never sounds
+    if (target->remainingSamples == 0U) {
+        target->isActive = false;
+    }
+}
+
+// Mix active voices into a buffer
+bool AudioMixer::mix(int16_t* buffer) {
+    bool hasActiveVoice = false;
+
+    for (std::size_t i = 0; i < BUFFER_SAMPLES; ++i) {
+        int32_t sample = 0;
+
+        for (Voice& voice : voices) {
+            if (!voice.isActive) {
+                continue;
+            }
+
+            hasActiveVoice = true;
+
+            if (voice.delaySamples > 0U) {
+                --voice.delaySamples;
+                continue;
+            }
+
+            // Linear attack and release ramps (Q15 gain) avoid clicks
+            int32_t gain = 32767;
+            if (voice.elapsedSamples < (1U << ATTACK_SHIFT)) {
+                gain = static_cast<int32_t>(voice.elapsedSamples << (15U - ATTACK_SHIFT));
+            }
+            if (voice.remainingSamples < (1U << RELEASE_SHIFT)) {
+                gain = std::min(gain, static_cast<int32_t>(voice.remainingSamples << (15U - RELEASE_SHIFT)));
+            }
+
+            sample += (wavetable[voice.phase >> 24] * gain) >> 15;
+            voice.phase += voice.phaseIncrement;
+            ++voice.elapsedSamples;
+
+            if (--voice.remainingSamples == 0U) {
+                voice.isActive = false;
+            }
+        }
+
+        // Clip to 16 bits
+        buffer[i] = static_cast<int16_t>(std::max<int32_t>(-32768, std::min<int32_t>(32767, sample)));
+    }
+
+    return hasActiveVoice;
+}
+
+// Get number of active voices
+std::size_t AudioMixer::getActiveVoiceCount() const {
+    std::size_t count = 0;
+
+    for (const Voice& voice : voices) {
+        if (voice.isActive) {
+            ++count;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,35 @@
+#include "BootProfiler.h"
+
+// Constructor
+BootProfiler::BootProfiler() {
+}
+
+// Timestamp a milestone
+void BootProfiler::mark(const char* name) {
+    const int64_t now = esp_timer_get_time();
+    const std::size_t index = milestoneCount.fetch_add(1);
+
+    if (index >= MAX_MILESTONE_COUNT) {
+        return;
+    }
+
+    milestones[index].name = name;
+    milestones[index].timeUs = now;
+}
+
+// Print milestones
+void BootProfiler::report(Print& output) const {
+    std::size_t count = milestoneCount.load();
+    if (count > MAX_MILESTONE_COUNT) {
+        count = MAX_MILESTONE_COUNT;
+    }
+
+    output.println("Boot milestones (time since boot, delta):");
+
+    int64_t previousUs = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const Milestone& milestone = milestones[i];
+        output.printf("  %-20s %8lld us  (+%lld us)\n", milestone.name, milestone.timeUs, milestone.timeUs - previousUs);
+        previousUs = milestone.timeUs;
+    }
+}
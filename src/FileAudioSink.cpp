@@ -0,0 +1,34 @@
+#include "FileAudioSink.h"
+
+// Constructor
+FileAudioSink::FileAudioSink(FILE* output)
+    : file(output) {
+}
+
+// Destructor
+FileAudioSink::~FileAudioSink() {
+    if (file != nullptr) {
+        fflush(file);
+    }
+}
+
+// Append a buffer to the file
+bool FileAudioSink::write(const int16_t* samples, std::size_t count, uint32_t sampleRate) {
+    (void)sampleRate;
+
+    if (file == nullptr) {
+        return false;
+    }
+
+    // Little-endian regardless of the host byte order
+    for (std::size_t i = 0; i < count; ++i) {
+        const uint16_t sample = static_cast<uint16_t>(samples[i]);
+        const unsigned char bytes[2] = {static_cast<unsigned char>(sample & 0xFFU), static_cast<unsigned char>(sample >> 8)};
+        if (fwrite(bytes, 1, sizeof(bytes), file) != sizeof(bytes)) {
+            return false;
+        }
+    }
+
+    sampleCount += count;
+    return true;
+}
@@ -0,0 +1,44 @@
+#include "FrameArena.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#else
+#include <cstdio>
+#include <cstdlib>
+#endif
+
+// Constructor
+FrameArena::FrameArena(std::size_t size) {
+#ifdef ARDUINO
+    // Allocate scratch buffer in internal SRAM
+    buffer = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+
+    if (!buffer) {
+        Serial.println("Failed to allocate frame arena");
+        return;
+    }
+#else
+    // Host builds (tests)
+    buffer = (uint8_t*)malloc(size);
+
+    if (!buffer) {
+        fprintf(stderr, "Failed to allocate frame arena\n");
+        return;
+    }
+#endif
+
+    capacity = size;
+}
+
+// Destructor
+FrameArena::~FrameArena() {
+    if (buffer) {
+#ifdef ARDUINO
+        heap_caps_free(buffer);
+#else
+        free(buffer);
+#endif
+        buffer = nullptr;
+    }
+}
@@ -0,0 +1,154 @@
+#include "HeapMonitor.h"
+#include <new>
+#include <sdkconfig.h>
+
+// Tracked capabilities
+const HeapMonitor::HeapCapability HeapMonitor::CAPABILITIES[CAPABILITY_COUNT] = {
+    {"internal", MALLOC_CAP_INTERNAL},
+    {"dma", MALLOC_CAP_DMA},
+    {"psram", MALLOC_CAP_SPIRAM}
+};
+
+// Allocation counter state
+TaskHandle_t HeapMonitor::watchedTask = nullptr;
+std::atomic<bool> HeapMonitor::isCountingEnabled{false};
+std::atomic<uint32_t> HeapMonitor::allocationCount{0};
+std::atomic<uint32_t> HeapMonitor::allocatedBytes{0};
+
+// Constructor
+HeapMonitor::HeapMonitor() {
+    for (std::size_t i = 0; i < CAPABILITY_COUNT; ++i) {
+        lowWaterMarks[i] = SIZE_MAX;
+    }
+}
+
+// Watch the calling task
+void HeapMonitor::watchCurrentTask(uint32_t warmupFrames) {
+    warmupFrameCount = warmupFrames;
+    frameCount = 0;
+    violatingFrameCount = 0;
+    lastAllocationCount = 0;
+    allocationCount.store(0);
+    allocatedBytes.store(0);
+    watchedTask = xTaskGetCurrentTaskHandle();
+}
+
+// Record an allocation (may run from the heap hook with the flash cache disabled)
+void IRAM_ATTR HeapMonitor::recordAllocation(std::size_t size) {
+    if (!isCountingEnabled.load(std::memory_order_relaxed) || watchedTask == nullptr) {
+        return;
+    }
+
+    if (xTaskGetCurrentTaskHandle() != watchedTask) {
+        return;
+    }
+
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(static_cast<uint32_t>(size), std::memory_order_relaxed);
+}
+
+// Sample free heap and check allocations at the end of a frame
+void HeapMonitor::endFrame() {
+    // Update low-water marks
+    for (std::size_t i = 0; i < CAPABILITY_COUNT; ++i) {
+        const std::size_t freeSize = heap_caps_get_free_size(CAPABILITIES[i].caps);
+        if (freeSize < lowWaterMarks[i]) {
+            lowWaterMarks[i] = freeSize;
+        }
+    }
+
+    ++frameCount;
+
+    // Start counting once the warmup frames are done
+    if (frameCount == warmupFrameCount) {
+        allocationCount.store(0);
+        allocatedBytes.store(0);
+        isCountingEnabled.store(true);
+        return;
+    }
+
+    // Count frames that allocated (the first one fails the check right away)
+    const uint32_t count = allocationCount.load();
+    if (count != lastAllocationCount) {
+        if (violatingFrameCount == 0) {
+            Serial.printf("HEAP CHECK FAIL: %u allocation(s) in frame %u after warmup\n",
+                          count - lastAllocationCount, frameCount);
+        }
+        ++violatingFrameCount;
+        lastAllocationCount = count;
+    }
+}
+
+// Print allocation counts and heap low-water marks
+bool HeapMonitor::report(Print& output) {
+    output.println("Heap low-water marks (free bytes):");
+    for (std::size_t i = 0; i < CAPABILITY_COUNT; ++i) {
+        output.printf("  %-8s now %7u  low %7u  largest block %7u\n",
+                      CAPABILITIES[i].name,
+                      (unsigned)heap_caps_get_free_size(CAPABILITIES[i].caps),
+                      (unsigned)lowWaterMarks[i],
+                      (unsigned)heap_caps_get_largest_free_block(CAPABILITIES[i].caps));
+    }
+
+#ifdef VORONOI_HEAP_DEBUG
+    const bool passed = isPassing();
+#ifdef CONFIG_HEAP_USE_HOOKS
+    output.println("Counting every heap allocation (ESP-IDF heap hook)");
+#else
+    output.println("Counting operator new only (enable CONFIG_HEAP_USE_HOOKS to include malloc)");
+#endif
+    output.printf("Frame allocations after %u warmup frames: %u (%u bytes) in %u of %u frames\n",
+                  warmupFrameCount, allocationCount.load(), allocatedBytes.load(),
+                  violatingFrameCount, frameCount);
+    output.println(passed ? "HEAP CHECK PASS" : "HEAP CHECK FAIL");
+    return passed;
+#else
+    output.println("Allocation counting disabled (build with -DVORONOI_HEAP_DEBUG)");
+    return true;
+#endif
+}
+
+#if defined(VORONOI_HEAP_DEBUG) && defined(CONFIG_HEAP_USE_HOOKS)
+// ESP-IDF heap hook (called for every successful allocation, including operator new through malloc)
+extern "C" void IRAM_ATTR esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps) {
+    (void)ptr;
+    (void)caps;
+    HeapMonitor::recordAllocation(size);
+}
+
+extern "C" void IRAM_ATTR esp_heap_trace_free_hook(void* ptr) {
+    (void)ptr;
+}
+#elif defined(VORONOI_HEAP_DEBUG)
+// Global operator new hook (fallback without heap hooks; C allocations are not seen)
+void* operator new(std::size_t size) {
+    HeapMonitor::recordAllocation(size);
+
+    void* ptr = malloc(size);
+    if (ptr == nullptr) {
+        abort();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    HeapMonitor::recordAllocation(size);
+    return malloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    free(ptr);
+}
+#endif
@@ -0,0 +1,308 @@
+#include "InputTrace.h"
+#include <cstring>
+
+#ifdef ARDUINO
+#include <esp_heap_caps.h>
+#else
+#include <cstdlib>
+#endif
+
+// Out-of-class definitions for constants used by address
+constexpr char InputTrace::MAGIC[4];
+
+// Constructor
+InputTrace::InputTrace(Print& out, ClockFunction clockFunction) : console(out), clock(clockFunction) {
+}
+
+// Destructor
+InputTrace::~InputTrace() {
+    if (records) {
+#ifdef ARDUINO
+        heap_caps_free(records);
+#else
+        free(records);
+#endif
+        records = nullptr;
+    }
+}
+
+// Allocate record buffer in PSRAM
+bool InputTrace::initialize() {
+    if (records) {
+        return true;
+    }
+
+#ifdef ARDUINO
+    records = (Record*)heap_caps_malloc(MAX_RECORD_COUNT * sizeof(Record), MALLOC_CAP_SPIRAM);
+#else
+    records = (Record*)malloc(MAX_RECORD_COUNT * sizeof(Record));
+#endif
+    if (!records) {
+        console.println("Failed to allocate trace buffer");
+        return false;
+    }
+
+    recordCount = 0;
+    return true;
+}
+
+// Request recording
+void InputTrace::requestRecording() {
+    pendingMode.store(Mode::RECORDING);
+    hasPendingMode.store(true);
+}
+
+// Request replay
+void InputTrace::requestReplay() {
+    pendingMode.store(Mode::REPLAYING);
+    hasPendingMode.store(true);
+}
+
+// Request stop
+void InputTrace::requestStop() {
+    pendingMode.store(Mode::IDLE);
+    hasPendingMode.store(true);
+}
+
+// Apply pending mode change
+bool InputTrace::applyPendingMode() {
+    if (!hasPendingMode.exchange(false)) {
+        return false;
+    }
+
+    const Mode requested = pendingMode.load();
+
+    // Finish the running session first
+    if (mode.load() == Mode::REPLAYING) {
+        finishReplay();
+    } else if (mode.load() == Mode::RECORDING) {
+        console.printf("Trace recorded: %u records, %u frames\n", recordCount, currentFrame);
+    }
+
+    // Sessions need a record buffer
+    if (requested != Mode::IDLE && !records) {
+        console.println("Trace buffer is not available");
+        mode.store(Mode::IDLE);
+        return false;
+    }
+
+    // Nothing to replay
+    if (requested == Mode::REPLAYING && recordCount == 0) {
+        console.println("Trace is empty");
+        mode.store(Mode::IDLE);
+        return false;
+    }
+
+    // Keep the results of the finished session readable until the next one starts
+    if (requested == Mode::IDLE) {
+        mode.store(Mode::IDLE);
+        return false;
+    }
+
+    if (requested == Mode::RECORDING) {
+        recordCount = 0;
+    }
+
+    replayCursor = 0;
+    replayedFrames = 0;
+    hashMismatches = 0;
+    randomDivergences = 0;
+    currentFrame = 0;
+    sessionStartMs = getMillis();
+    mode.store(requested);
+
+    return true;
+}
+
+// Append a record
+void InputTrace::append(RecordType type, uint32_t frame, uint32_t value, uint8_t finger) {
+    if (recordCount >= MAX_RECORD_COUNT) {
+        // Stop recording when the buffer is full
+        console.println("Trace buffer full, recording stopped");
+        requestStop();
+        return;
+    }
+
+    Record& record = records[recordCount++];
+    record.timestampMs = getMillis() - sessionStartMs;
+    record.frame = frame;
+    record.type = static_cast<uint8_t>(type) | (finger << 4);
+    record.value = value;
+}
+
+// Record touch event
+void InputTrace::recordTouch(RecordType type, uint32_t frame, uint8_t finger, int16_t x, int16_t y) {
+    if (mode.load() != Mode::RECORDING) {
+        return;
+    }
+
+    currentFrame = frame;
+
+    // Pack coordinates into the value field
+    Record packed = {};
+    packed.touch.x = x;
+    packed.touch.y = y;
+    append(type, frame, packed.value, finger);
+}
+
+// Record random draw
+void InputTrace::recordRandom(uint32_t value) {
+    if (mode.load() != Mode::RECORDING) {
+        return;
+    }
+
+    append(RecordType::RANDOM, currentFrame, value);
+}
+
+// Record frame hash
+void InputTrace::recordFrameHash(uint32_t frame, uint32_t hash) {
+    if (mode.load() != Mode::RECORDING) {
+        return;
+    }
+
+    currentFrame = frame + 1;
+    append(RecordType::FRAME_HASH, frame, hash);
+}
+
+// Get next touch event for the current frame
+bool InputTrace::nextTouch(RecordType& type, uint8_t& finger, int16_t& x, int16_t& y) {
+    if (mode.load() != Mode::REPLAYING) {
+        return false;
+    }
+
+    while (replayCursor < recordCount) {
+        const Record& record = records[replayCursor];
+        const RecordType recordType = static_cast<RecordType>(record.type & TYPE_MASK);
+
+        // Frame boundary reached
+        if (recordType == RecordType::FRAME_HASH) {
+            return false;
+        }
+
+        ++replayCursor;
+
+        // Random draw not consumed by the diagram
+        if (recordType == RecordType::RANDOM) {
+            ++randomDivergences;
+            continue;
+        }
+
+        type = recordType;
+        finger = record.type >> 4;
+        x = record.touch.x;
+        y = record.touch.y;
+        return true;
+    }
+
+    return false;
+}
+
+// Get next random draw
+bool InputTrace::nextRandom(uint32_t& value) {
+    if (mode.load() != Mode::REPLAYING) {
+        return false;
+    }
+
+    if (replayCursor < recordCount && records[replayCursor].type == static_cast<uint8_t>(RecordType::RANDOM)) {
+        value = records[replayCursor++].value;
+        return true;
+    }
+
+    // Diagram asked for a draw the trace does not have
+    ++randomDivergences;
+    return false;
+}
+
+// Compare frame hash against the trace
+void InputTrace::checkFrameHash(uint32_t frame, uint32_t hash) {
+    if (mode.load() != Mode::REPLAYING) {
+        return;
+    }
+
+    if (replayCursor >= recordCount) {
+        requestStop();
+        return;
+    }
+
+    const Record& record = records[replayCursor];
+    if (record.type == static_cast<uint8_t>(RecordType::FRAME_HASH)) {
+        ++replayCursor;
+        if (record.value != hash) {
+            ++hashMismatches;
+            console.printf("Frame %u hash mismatch: expected %08x, got %08x\n", frame, record.value, hash);
+        }
+    }
+
+    ++replayedFrames;
+    currentFrame = frame + 1;
+
+    // End of trace
+    if (replayCursor >= recordCount) {
+        requestStop();
+    }
+}
+
+// Finish replay and print summary
+void InputTrace::finishReplay() {
+    const uint32_t elapsedMs = getMillis() - sessionStartMs;
+    const uint32_t recordedMs = (recordCount > 0) ? records[recordCount - 1].timestampMs : 0;
+
+    console.printf("Replay finished: %u frames in %u ms (recorded %u ms)\n", replayedFrames, elapsedMs, recordedMs);
+    if (replayedFrames > 0) {
+        console.printf("Average frame time: %u us\n", (uint32_t)((uint64_t)elapsedMs * 1000U / replayedFrames));
+    }
+    console.printf("Hash mismatches: %u, random divergences: %u\n", hashMismatches, randomDivergences);
+    console.println((hashMismatches == 0 && randomDivergences == 0) ? "REPLAY PASS" : "REPLAY FAIL");
+}
+
+// Write trace in binary format
+bool InputTrace::writeTo(Print& output) const {
+    if (!records || mode.load() != Mode::IDLE) {
+        return false;
+    }
+
+    Header header = {};
+    memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = FORMAT_VERSION;
+    header.recordSize = sizeof(Record);
+    header.recordCount = recordCount;
+
+    output.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const uint8_t*>(records), recordCount * sizeof(Record));
+    return true;
+}
+
+// Read trace in binary format
+bool InputTrace::readFrom(Stream& input) {
+    if (!records || mode.load() != Mode::IDLE) {
+        return false;
+    }
+
+    // Validate header
+    Header header = {};
+    if (input.readBytes(reinterpret_cast<uint8_t*>(&header), sizeof(header)) != sizeof(header)) {
+        console.println("Trace header truncated");
+        return false;
+    }
+
+    const bool isValidHeader = (memcmp(header.magic, MAGIC, sizeof(header.magic)) == 0
+        && header.version == FORMAT_VERSION
+        && header.recordSize == sizeof(Record)
+        && header.recordCount <= MAX_RECORD_COUNT);
+
+    if (!isValidHeader) {
+        console.println("Invalid trace header");
+        return false;
+    }
+
+    // Read records
+    const size_t byteCount = header.recordCount * sizeof(Record);
+    if (input.readBytes(reinterpret_cast<uint8_t*>(records), byteCount) != byteCount) {
+        console.println("Trace records truncated");
+        recordCount = 0;
+        return false;
+    }
+
+    recordCount = header.recordCount;
+    return true;
+}
@@ -0,0 +1,313 @@
+#include "LabelStream.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#else
+#include <cstdio>
+#include <cstdlib>
+#endif
+
+// Out-of-class definitions for constants used by address
+constexpr char LabelStream::MAGIC[4];
+
+// Allocate a stream buffer (in PSRAM on the device)
+static uint8_t* allocateBuffer(std::size_t size) {
+#ifdef ARDUINO
+    return (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+#else
+    return (uint8_t*)malloc(size);
+#endif
+}
+
+// Free a stream buffer
+static void freeBuffer(uint8_t*& buffer) {
+    if (buffer) {
+#ifdef ARDUINO
+        heap_caps_free(buffer);
+#else
+        free(buffer);
+#endif
+        buffer = nullptr;
+    }
+}
+
+// Constructor
+LabelStream::LabelStream(Print& out, ClockFunction clockFunction) : output(out), clock(clockFunction) {
+}
+
+// Destructor
+LabelStream::~LabelStream() {
+    freeBuffer(packet);
+    freeBuffer(referenceLabels);
+    freeBuffer(emptyRow);
+}
+
+// Allocate packet and reference buffers
+bool LabelStream::initialize(int w, int h) {
+    if (packet) {
+        return true;
+    }
+
+    const std::size_t pixelCount = static_cast<std::size_t>(w) * h;
+    packet = allocateBuffer(MAX_PACKET_SIZE);
+    referenceLabels = allocateBuffer(pixelCount);
+    emptyRow = allocateBuffer(w);
+
+    if (!packet || !referenceLabels || !emptyRow) {
+#ifdef ARDUINO
+        Serial.println("Failed to allocate label stream buffers");
+#else
+        fprintf(stderr, "Failed to allocate label stream buffers\n");
+#endif
+        freeBuffer(packet);
+        freeBuffer(referenceLabels);
+        freeBuffer(emptyRow);
+        return false;
+    }
+
+    memset(emptyRow, NO_SEED, w);
+    width = w;
+    height = h;
+    return true;
+}
+
+// Request start
+void LabelStream::requestStart() {
+    if (!packet) {
+        return;
+    }
+
+    isStopRequested.store(false);
+    isStartRequested.store(true);
+}
+
+// Request stop
+void LabelStream::requestStop() {
+    isStopRequested.store(true);
+}
+
+// Encode and send a frame
+void LabelStream::encodeFrame(uint32_t frame, const uint8_t* labels, const VoronoiCore::Point* points,
+                              std::size_t pointCount) {
+    // Start a new stream with a keyframe
+    if (isStartRequested.exchange(false)) {
+        packetSize = 0;
+        sentSize = 0;
+        isKeyframeNeeded = true;
+        isActive.store(true);
+    }
+
+    if (!isActive.load()) {
+        return;
+    }
+
+    // Continue sending the previous packet
+    sendPending();
+    if (sentSize < packetSize) {
+        ++skippedFrameCount;
+        return;
+    }
+
+    // Stop once the last packet has been sent completely
+    if (isStopRequested.exchange(false)) {
+        isActive.store(false);
+        return;
+    }
+
+    const int64_t startUs = clock();
+    std::size_t seedCount = pointCount;
+    if (seedCount > VoronoiCore::MAX_POINT_COUNT) {
+        seedCount = VoronoiCore::MAX_POINT_COUNT;
+    }
+    const bool isKeyframe = isKeyframeNeeded || packetsSinceKeyframe >= KEYFRAME_INTERVAL;
+
+    // Nothing to send if neither the seeds nor any row changed
+    bool isChanged = isKeyframe || isSeedTableChanged(points, seedCount);
+    for (int y = 0; y < height && !isChanged; ++y) {
+        const uint8_t* row = labels ? labels + y * width : emptyRow;
+        isChanged = isRowChanged(row, referenceLabels + y * width);
+    }
+
+    if (!isChanged) {
+        ++unchangedFrameCount;
+        return;
+    }
+
+    // Header (completed after the rows are known)
+    packetSize = 0;
+    PacketHeader header = {};
+    memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = FORMAT_VERSION;
+    header.flags = isKeyframe ? FLAG_KEYFRAME : 0;
+    header.width = width;
+    header.height = height;
+    header.seedCount = seedCount;
+    header.frame = frame;
+    bool isComplete = append(&header, sizeof(header));
+
+    // Seed table
+    for (std::size_t i = 0; i < seedCount && isComplete; ++i) {
+        const Seed seed = {static_cast<int16_t>(points[i].x), static_cast<int16_t>(points[i].y), points[i].color};
+        isComplete = append(&seed, sizeof(seed));
+        referenceSeeds[i] = seed;
+    }
+    referenceSeedCount = seedCount;
+
+    // Rows (all rows for a keyframe, changed rows otherwise)
+    for (int y = 0; y < height && isComplete; ++y) {
+        const uint8_t* row = labels ? labels + y * width : emptyRow;
+        uint8_t* reference = referenceLabels + y * width;
+
+        if (!isKeyframe && !isRowChanged(row, reference)) {
+            continue;
+        }
+
+        isComplete = appendRow(y, row);
+        memcpy(reference, row, width);
+        ++header.rowCount;
+    }
+
+    // Complete the header first, since its fields are covered by the hash
+    header.payloadSize = packetSize - sizeof(header);
+    memcpy(packet, &header, sizeof(header));
+
+    // Hash of the header fields after the magic and the payload (FNV-1a)
+    uint32_t hash = 2166136261U;
+    for (std::size_t i = sizeof(header.magic); i < packetSize; ++i) {
+        hash = (hash ^ packet[i]) * 16777619U;
+    }
+    isComplete = isComplete && append(&hash, sizeof(hash));
+
+    if (!isComplete) {
+        // The reference is out of sync with what the decoder has, so start over
+        ++overflowCount;
+        packetSize = 0;
+        isKeyframeNeeded = true;
+        return;
+    }
+
+    sentSize = 0;
+
+    // Update statistics
+    const uint32_t encodeUs = static_cast<uint32_t>(clock() - startUs);
+    ++packetCount;
+    totalBytes += packetSize;
+    maxBytes = std::max(maxBytes, static_cast<uint32_t>(packetSize));
+    totalEncodeUs += encodeUs;
+    maxEncodeUs = std::max(maxEncodeUs, encodeUs);
+
+    if (isKeyframe) {
+        ++keyframeCount;
+        packetsSinceKeyframe = 0;
+        isKeyframeNeeded = false;
+    } else {
+        ++packetsSinceKeyframe;
+    }
+
+    sendPending();
+}
+
+// Append bytes to the packet
+bool LabelStream::append(const void* data, std::size_t size) {
+    if (packetSize + size > MAX_PACKET_SIZE) {
+        return false;
+    }
+
+    memcpy(packet + packetSize, data, size);
+    packetSize += size;
+    return true;
+}
+
+// Append the runs of a row
+bool LabelStream::appendRow(int y, const uint8_t* row) {
+    // Reserve the row header
+    const std::size_t headerOffset = packetSize;
+    RowHeader rowHeader = {static_cast<uint16_t>(y), 0};
+    if (!append(&rowHeader, sizeof(rowHeader))) {
+        return false;
+    }
+
+    // Runs longer than MAX_RUN_LENGTH are split
+    int x = 0;
+    while (x < width) {
+        const uint8_t label = row[x];
+        int length = 1;
+        while (x + length < width && row[x + length] == label && length < MAX_RUN_LENGTH) {
+            ++length;
+        }
+
+        const uint8_t run[2] = {static_cast<uint8_t>(length), label};
+        if (!append(run, sizeof(run))) {
+            return false;
+        }
+
+        ++rowHeader.runCount;
+        x += length;
+    }
+
+    memcpy(packet + headerOffset, &rowHeader, sizeof(rowHeader));
+    return true;
+}
+
+// Check if a row differs from the reference
+bool LabelStream::isRowChanged(const uint8_t* row, const uint8_t* reference) const {
+    return memcmp(row, reference, width) != 0;
+}
+
+// Check if the seed table differs from the reference
+bool LabelStream::isSeedTableChanged(const VoronoiCore::Point* points, std::size_t count) const {
+    if (count != referenceSeedCount) {
+        return true;
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const Seed& seed = referenceSeeds[i];
+        if (seed.x != points[i].x || seed.y != points[i].y || seed.color != points[i].color) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Write as much of the pending packet as the output accepts without blocking
+void LabelStream::sendPending() {
+    if (sentSize >= packetSize) {
+        return;
+    }
+
+    const int writable = output.availableForWrite();
+    if (writable <= 0) {
+        return;
+    }
+
+    const std::size_t remaining = packetSize - sentSize;
+    const std::size_t chunk = (remaining < static_cast<std::size_t>(writable)) ? remaining : static_cast<std::size_t>(writable);
+    sentSize += output.write(packet + sentSize, chunk);
+}
+
+// Print and reset statistics
+void LabelStream::printStatistics(Print& out) {
+    out.printf("Label stream: %u packets (%u keyframes), %u unchanged, %u skipped while sending, %u overflows\n",
+               packetCount, keyframeCount, unchangedFrameCount, skippedFrameCount, overflowCount);
+
+    if (packetCount > 0) {
+        out.printf("Bytes per packet: average %u, max %u (raw frame %u)\n",
+                   (uint32_t)(totalBytes / packetCount), maxBytes, (uint32_t)(width * height));
+        out.printf("Encode time: average %u us, max %u us\n",
+                   (uint32_t)(totalEncodeUs / packetCount), maxEncodeUs);
+    }
+
+    packetCount = 0;
+    keyframeCount = 0;
+    unchangedFrameCount = 0;
+    skippedFrameCount = 0;
+    overflowCount = 0;
+    totalBytes = 0;
+    maxBytes = 0;
+    totalEncodeUs = 0;
+    maxEncodeUs = 0;
+}
@@ -0,0 +1,32 @@
+#include "M5SpeakerAudioSink.h"
+
+// Constructor
+M5SpeakerAudioSink::M5SpeakerAudioSink() {
+}
+
+// Destructor
+M5SpeakerAudioSink::~M5SpeakerAudioSink() {
+}
+
+// Set the speaker volume
+void M5SpeakerAudioSink::begin() {
+    M5.Speaker.setVolume(DEFAULT_VOLUME);
+}
+
+// Block until the speaker channel has room for another buffer
+void M5SpeakerAudioSink::waitForRoom() {
+    // One buffer playing and one queued is enough to stream without gaps
+    while (M5.Speaker.isPlaying(SPEAKER_CHANNEL) >= 2) {
+        vTaskDelay(1);
+    }
+}
+
+// Check if the speaker channel ran dry
+bool M5SpeakerAudioSink::isDrained() const {
+    return M5.Speaker.isPlaying(SPEAKER_CHANNEL) == 0;
+}
+
+// Queue a buffer on the speaker channel
+bool M5SpeakerAudioSink::write(const int16_t* samples, std::size_t count, uint32_t sampleRate) {
+    return M5.Speaker.playRaw(samples, count, sampleRate, false, 1, SPEAKER_CHANNEL);
+}
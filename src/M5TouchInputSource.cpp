@@ -0,0 +1,66 @@
+#include "M5TouchInputSource.h"
+#include <esp_timer.h>
+
+// Instance notified by the interrupt handler
+M5TouchInputSource* M5TouchInputSource::instance = nullptr;
+
+// Constructor
+M5TouchInputSource::M5TouchInputSource() {
+}
+
+// Destructor
+M5TouchInputSource::~M5TouchInputSource() {
+    if (instance == this) {
+        detachInterrupt(digitalPinToInterrupt(TOUCH_INT_PIN));
+        instance = nullptr;
+    }
+}
+
+// Attach the touch interrupt
+void M5TouchInputSource::begin(TaskHandle_t task) {
+    notifyTask = task;
+    instance = this;
+
+    // The panel pulls its interrupt line low when a touch starts
+    pinMode(TOUCH_INT_PIN, INPUT);
+    attachInterrupt(digitalPinToInterrupt(TOUCH_INT_PIN), &M5TouchInputSource::handleInterrupt, FALLING);
+}
+
+// Block until the touch panel signals an interrupt
+bool M5TouchInputSource::waitForActivity(uint32_t timeoutMs) {
+    return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs)) > 0;
+}
+
+// Sample current touch points
+uint8_t M5TouchInputSource::read(TouchPoint* points, uint8_t maxCount) {
+    // Update M5Stack state
+    M5.update();
+
+    uint8_t touchCount = M5.Touch.getCount();
+    if (touchCount > maxCount) {
+        touchCount = maxCount;
+    }
+
+    for (uint8_t i = 0; i < touchCount; ++i) {
+        const m5::touch_detail_t& detail = M5.Touch.getDetail(i);
+        points[i].x = detail.x;
+        points[i].y = detail.y;
+        points[i].id = detail.id;
+    }
+
+    return touchCount;
+}
+
+// Touch interrupt handler (static)
+void IRAM_ATTR M5TouchInputSource::handleInterrupt() {
+    M5TouchInputSource* self = instance;
+    if (self == nullptr || self->notifyTask == nullptr) {
+        return;
+    }
+
+    self->lastInterruptTimeUs = esp_timer_get_time();
+
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(self->notifyTask, &higherPriorityTaskWoken);
+    portYIELD_FROM_ISR(higherPriorityTaskWoken);
+}
@@ -0,0 +1,86 @@
+#include "RenderCheck.h"
+#include <algorithm>
+
+// Fixed seed sets
+const RenderCheck::SeedSet RenderCheck::SEED_SETS[] = {
+    {"single",  0x00000001U, 1U},
+    {"pair",    0x0000BEEFU, 2U},
+    {"corners", 0x00000000U, 4U},
+    {"sparse",  0x12345678U, 5U},
+    {"medium",  0x9E3779B9U, 10U},
+    {"full",    0xC0FFEE00U, 16U}
+};
+
+const std::size_t RenderCheck::SEED_SET_COUNT = sizeof(SEED_SETS) / sizeof(SEED_SETS[0]);
+
+// Generate points for a seed set
+void RenderCheck::generatePoints(const SeedSet& set, int width, int height, std::vector<VoronoiCore::Point>& out) {
+    out.clear();
+
+    // Points on the screen corners
+    if (set.seed == 0U) {
+        out.push_back({0, 0, 0});
+        out.push_back({width - 1, 0, 0});
+        out.push_back({0, height - 1, 0});
+        out.push_back({width - 1, height - 1, 0});
+        return;
+    }
+
+    // Points from a linear congruential generator
+    uint32_t state = set.seed;
+    for (std::size_t i = 0; i < set.count; ++i) {
+        const int x = nextRandom(state) % width;
+        const int y = nextRandom(state) % height;
+        out.push_back({x, y, 0});
+    }
+}
+
+// Move the last point by the drag offset
+void RenderCheck::dragLastPoint(std::vector<VoronoiCore::Point>& points, int width, int height) {
+    if (points.empty()) {
+        return;
+    }
+
+    VoronoiCore::Point& dragged = points.back();
+    dragged.x = std::min(std::max(dragged.x + DRAG_OFFSET_X, 0), width - 1);
+    dragged.y = std::min(std::max(dragged.y + DRAG_OFFSET_Y, 0), height - 1);
+}
+
+// Compare labels against the reference labels
+void RenderCheck::compareLabels(const VoronoiCore::Point* seeds, std::size_t count, int width, int height,
+                                const int16_t* reference, const int16_t* actual,
+                                uint32_t& labelMismatches, uint32_t& distanceMismatches) {
+    const int numPoints = static_cast<int>(count);
+
+    labelMismatches = 0;
+    distanceMismatches = 0;
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const int idx = y * width + x;
+            const int expected = reference[idx];
+            const int label = actual[idx];
+
+            if (label == expected) {
+                continue;
+            }
+
+            ++labelMismatches;
+
+            // Unassigned or invalid label
+            if (label < 0 || label >= numPoints) {
+                ++distanceMismatches;
+                continue;
+            }
+
+            // Equidistant points are both correct
+            const int dx1 = x - seeds[label].x;
+            const int dy1 = y - seeds[label].y;
+            const int dx2 = x - seeds[expected].x;
+            const int dy2 = y - seeds[expected].y;
+            if (dx1 * dx1 + dy1 * dy1 != dx2 * dx2 + dy2 * dy2) {
+                ++distanceMismatches;
+            }
+        }
+    }
+}
@@ -0,0 +1,174 @@
+#include "RenderSelfTest.h"
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <cstdio>
+
+// Render paths under test (the incremental path is exact)
+const RenderSelfTest::PathSpec RenderSelfTest::PATHS[] = {
+    {VoronoiDiagram::RenderPath::JFA, "jfa", RenderCheck::JFA_MAX_ERROR_RATIO},
+    {VoronoiDiagram::RenderPath::INCREMENTAL, "incremental", 0.0F}
+};
+
+// Out-of-class definitions (odr-used by the timing checks)
+constexpr float RenderSelfTest::BASELINE_TOLERANCE;
+constexpr int64_t RenderSelfTest::BASELINE_SLACK_US;
+
+// Constructor
+RenderSelfTest::RenderSelfTest(VoronoiDiagram& voronoi)
+    : voronoiDiagram(voronoi) {
+}
+
+// Render labels through a path (fastest of several runs)
+bool RenderSelfTest::renderPath(const PathSpec& spec, const std::vector<VoronoiDiagram::Point>& seeds, int64_t& micros) {
+    micros = INT64_MAX;
+
+    for (int run = 0; run < TIMING_RUN_COUNT; ++run) {
+        bool rendered = false;
+        int64_t start = 0;
+
+        if (spec.path != VoronoiDiagram::RenderPath::INCREMENTAL) {
+            start = esp_timer_get_time();
+            rendered = voronoiDiagram.computeLabels(seeds.data(), seeds.size(), spec.path, candidateLabels);
+        } else {
+            // Simulate a drag of the last point: label the points before the drag,
+            // then time only the incremental update to the current points
+            previousSeeds = seeds;
+            RenderCheck::dragLastPoint(previousSeeds, voronoiDiagram.getWidth(), voronoiDiagram.getHeight());
+
+            if (!voronoiDiagram.computeLabels(previousSeeds.data(), previousSeeds.size(),
+                                              VoronoiDiagram::RenderPath::BRUTE_FORCE, candidateLabels)) {
+                return false;
+            }
+
+            start = esp_timer_get_time();
+            rendered = voronoiDiagram.updateLabels(previousSeeds.data(), seeds.data(), seeds.size(), candidateLabels);
+        }
+
+        const int64_t elapsed = esp_timer_get_time() - start;
+        if (!rendered) {
+            return false;
+        }
+
+        micros = std::min(micros, elapsed);
+    }
+
+    return true;
+}
+
+// Check a timing against its stored baseline
+const char* RenderSelfTest::checkBaseline(std::size_t setIndex, std::size_t pathIndex, int64_t micros,
+                                          bool updateBaselines, uint32_t& baselineMicros, bool& isFastEnough) {
+    // NVS keys are limited to 15 characters, so use indices (path 0 is brute force)
+    char key[16];
+    snprintf(key, sizeof(key), "t%u_%u", (unsigned)setIndex, (unsigned)pathIndex);
+
+    baselineMicros = baselines.getUInt(key, 0U);
+    isFastEnough = true;
+
+    if (updateBaselines || baselineMicros == 0U) {
+        baselines.putUInt(key, static_cast<uint32_t>(micros));
+        return "new";
+    }
+
+    isFastEnough = (micros <= baselineMicros * BASELINE_TOLERANCE + BASELINE_SLACK_US);
+    return isFastEnough ? "ok" : "FAIL (speed)";
+}
+
+// Run all seed sets through all render paths
+bool RenderSelfTest::run(Print& output, bool updateBaselines) {
+    const int width = voronoiDiagram.getWidth();
+    const int height = voronoiDiagram.getHeight();
+    const std::size_t pixelCount = static_cast<std::size_t>(width) * height;
+
+    // Allocate label maps in PSRAM
+    referenceLabels = (int16_t*)heap_caps_malloc(pixelCount * sizeof(int16_t), MALLOC_CAP_SPIRAM);
+    candidateLabels = (int16_t*)heap_caps_malloc(pixelCount * sizeof(int16_t), MALLOC_CAP_SPIRAM);
+
+    if (!referenceLabels || !candidateLabels) {
+        output.println("Failed to allocate self-test label maps");
+        heap_caps_free(referenceLabels);
+        heap_caps_free(candidateLabels);
+        referenceLabels = nullptr;
+        candidateLabels = nullptr;
+        return false;
+    }
+
+    if (!baselines.begin("selftest", false)) {
+        output.println("Failed to open self-test baselines");
+    }
+
+    std::vector<VoronoiDiagram::Point> seeds;
+    seeds.reserve(32U);
+    previousSeeds.reserve(32U);
+
+    bool allPassed = true;
+
+    output.printf("Render self-test (%dx%d)\n", width, height);
+    output.println("set      seeds path         time_us  baseline  mismatched  farther  result");
+
+    for (std::size_t setIndex = 0; setIndex < RenderCheck::SEED_SET_COUNT; ++setIndex) {
+        const RenderCheck::SeedSet& set = RenderCheck::SEED_SETS[setIndex];
+        RenderCheck::generatePoints(set, width, height, seeds);
+
+        // Exact reference (fastest of several runs)
+        int64_t referenceMicros = INT64_MAX;
+        for (int run = 0; run < TIMING_RUN_COUNT; ++run) {
+            const int64_t start = esp_timer_get_time();
+            voronoiDiagram.computeLabels(seeds.data(), seeds.size(), VoronoiDiagram::RenderPath::BRUTE_FORCE, referenceLabels);
+            referenceMicros = std::min(referenceMicros, esp_timer_get_time() - start);
+        }
+
+        uint32_t referenceBaseline = 0;
+        bool isReferenceFastEnough = true;
+        const char* referenceResult = checkBaseline(setIndex, 0U, referenceMicros, updateBaselines,
+                                                    referenceBaseline, isReferenceFastEnough);
+        allPassed = allPassed && isReferenceFastEnough;
+
+        output.printf("%-8s %5u %-11s %8lld  %8u  %10u  %7u  %s\n",
+                      set.name, (unsigned)seeds.size(), "brute-force", referenceMicros, referenceBaseline, 0U, 0U,
+                      referenceResult);
+
+        for (std::size_t pathIndex = 0; pathIndex < sizeof(PATHS) / sizeof(PATHS[0]); ++pathIndex) {
+            const PathSpec& spec = PATHS[pathIndex];
+            int64_t micros = 0;
+            const bool rendered = renderPath(spec, seeds, micros);
+
+            // Skip paths whose buffers are not available
+            if (!rendered) {
+                output.printf("%-8s %5u %-11s %8s  %8s  %10s  %7s  %s\n",
+                              set.name, (unsigned)seeds.size(), spec.name, "-", "-", "-", "-", "skipped");
+                continue;
+            }
+
+            uint32_t labelMismatches = 0;
+            uint32_t distanceMismatches = 0;
+            RenderCheck::compareLabels(seeds.data(), seeds.size(), width, height, referenceLabels, candidateLabels,
+                                       labelMismatches, distanceMismatches);
+
+            // Check accuracy and speed (path indices start at 1 after brute force)
+            uint32_t baselineMicros = 0;
+            bool isFastEnough = true;
+            const char* speedResult = checkBaseline(setIndex, pathIndex + 1U, micros, updateBaselines,
+                                                    baselineMicros, isFastEnough);
+            const bool isAccurate = (distanceMismatches <= spec.maxErrorRatio * pixelCount);
+            allPassed = allPassed && isAccurate && isFastEnough;
+
+            output.printf("%-8s %5u %-11s %8lld  %8u  %10u  %7u  %s\n",
+                          set.name, (unsigned)seeds.size(), spec.name, micros, baselineMicros,
+                          labelMismatches, distanceMismatches,
+                          isAccurate ? speedResult : "FAIL (accuracy)");
+        }
+    }
+
+    output.println(allPassed ? "SELF-TEST PASS" : "SELF-TEST FAIL");
+
+    baselines.end();
+
+    // Free label maps
+    heap_caps_free(referenceLabels);
+    heap_caps_free(candidateLabels);
+    referenceLabels = nullptr;
+    candidateLabels = nullptr;
+
+    return allPassed;
+}
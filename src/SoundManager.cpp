@@ -1,33 +1,128 @@
 #include "SoundManager.h"
 
 // Constructor
-SoundManager::SoundManager() {
+SoundManager::SoundManager(AudioSink& sink)
+    : audioSink(sink) {
+}
+
+// Destructor
+SoundManager::~SoundManager() {
+    if (audioTaskHandle != nullptr) {
+        vTaskDelete(audioTaskHandle);
+        audioTaskHandle = nullptr;
+    }
 }
 
 // Initialize sound system
 void SoundManager::initialize() {
-    // Set volume
-    M5.Speaker.setVolume(DEFAULT_VOLUME);
+    // Prepare the sink (sets the speaker volume on the device)
+    audioSink.begin();
+
+    // Create audio task (runs on CPU0, above the touch task so that mixing is never starved)
+    BaseType_t result = xTaskCreatePinnedToCore(
+        &SoundManager::audioTaskFunction,
+        "AudioTask",
+        AUDIO_TASK_STACK_SIZE,
+        this,
+        3,  // Highest priority
+        &audioTaskHandle,
+        0   // Run on CPU0
+    );
+
+    if (result != pdPASS) {
+        Serial.println("Failed to create Audio task");
+        audioTaskHandle = nullptr;
+    }
 }
 
 // Play a sound effect
 void SoundManager::playSound(SoundType type) {
     switch (type) {
         case SoundType::TOUCH:
-            M5.Speaker.tone(TOUCH_FREQUENCY, TOUCH_DURATION);
+            enqueueTone(TOUCH_FREQUENCY, TOUCH_DURATION, 0U);
             break;
         case SoundType::STARTUP:
-            M5.Speaker.tone(STARTUP_FREQUENCY, STARTUP_DURATION);
+            enqueueTone(STARTUP_FREQUENCY, STARTUP_DURATION, 0U);
+            break;
+        case SoundType::EVICTION:
+            enqueueTone(EVICTION_FREQUENCY, EVICTION_DURATION, 0U);
             break;
     }
 }
 
 // Play startup sequence
 void SoundManager::playStartupSequence() {
-    // Play three tones in sequence
-    playSound(SoundType::STARTUP);
-    vTaskDelay(STARTUP_DELAY);
-    playSound(SoundType::STARTUP);
-    vTaskDelay(STARTUP_DELAY);
-    playSound(SoundType::STARTUP);
+    // Queue three tones in sequence (the audio task handles the delays)
+    enqueueTone(STARTUP_FREQUENCY, STARTUP_DURATION, 0U);
+    enqueueTone(STARTUP_FREQUENCY, STARTUP_DURATION, STARTUP_DELAY);
+    enqueueTone(STARTUP_FREQUENCY, STARTUP_DURATION, STARTUP_DELAY * 2U);
+}
+
+// Enqueue a tone
+void SoundManager::enqueueTone(float frequency, uint32_t durationMs, uint32_t delayMs) {
+    const SoundCommand command = {frequency, static_cast<uint16_t>(durationMs), static_cast<uint16_t>(delayMs)};
+
+    if (!commandQueue.push(command)) {
+        droppedCommandCount.fetch_add(1);
+        return;
+    }
+
+    // Wake the audio task if it is idle
+    if (audioTaskHandle != nullptr) {
+        xTaskNotifyGive(audioTaskHandle);
+    }
+}
+
+// Print and reset audio statistics
+void SoundManager::printStatistics(Print& output) {
+    output.printf("Audio: %u buffers mixed, %u underruns, %u commands dropped\n",
+                  mixedBufferCount.exchange(0), underrunCount.exchange(0), droppedCommandCount.exchange(0));
+}
+
+// Audio task function (static)
+void SoundManager::audioTaskFunction(void* args) {
+    // Early return if args is null
+    if (args == nullptr) {
+        Serial.println("Audio task args is null");
+        vTaskDelete(nullptr);
+        return;
+    }
+
+    // Get this pointer
+    SoundManager* self = static_cast<SoundManager*>(args);
+    bool isStreaming = false;
+
+    // Task main loop
+    for (;;) {
+        // Start voices for queued commands
+        SoundCommand command = {};
+        while (self->commandQueue.pop(command)) {
+            self->mixer.startTone(command.frequency, command.durationMs, command.delayMs);
+        }
+
+        // Mix the next buffer
+        int16_t* buffer = self->buffers[self->nextBufferIndex];
+        if (!self->mixer.mix(buffer)) {
+            // Sleep until a command arrives
+            isStreaming = false;
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        // Wait until the sink has room for another buffer
+        self->audioSink.waitForRoom();
+
+        // The sink ran dry while we were streaming
+        if (isStreaming && self->audioSink.isDrained()) {
+            self->underrunCount.fetch_add(1);
+        }
+
+        self->audioSink.write(buffer, AudioMixer::BUFFER_SAMPLES, AudioMixer::SAMPLE_RATE);
+        self->nextBufferIndex = (self->nextBufferIndex + 1) % BUFFER_COUNT;
+        self->mixedBufferCount.fetch_add(1);
+        isStreaming = true;
+    }
+
+    // Delete task (should never reach here)
+    vTaskDelete(nullptr);
 }
@@ -0,0 +1,87 @@
+#include "SyntheticInputSource.h"
+#include <algorithm>
+
+// Constructor
+SyntheticInputSource::SyntheticInputSource(int width, int height, ClockFunction clockFunction, uint32_t seed)
+    : screenWidth(std::max(width, 1)), screenHeight(std::max(height, 1)), clock(clockFunction), randomState(seed) {
+}
+
+// Start the script
+void SyntheticInputSource::begin(TaskHandle_t task) {
+    (void)task;
+
+    nextStroke();
+}
+
+// Next value of the linear congruential generator
+uint32_t SyntheticInputSource::nextRandom() {
+    randomState = randomState * 1664525U + 1013904223U;
+    return randomState >> 8;
+}
+
+// Advance to the next stroke (every third stroke is a drag, the others are taps)
+void SyntheticInputSource::nextStroke() {
+    strokeStartUs += static_cast<int64_t>(STROKE_INTERVAL_MS) * 1000;
+    const int64_t nowUs = clock();
+    if (strokeStartUs < nowUs) {
+        strokeStartUs = nowUs + static_cast<int64_t>(STROKE_INTERVAL_MS) * 1000;
+    }
+
+    ++strokeId;
+    startX = nextRandom() % screenWidth;
+    startY = nextRandom() % screenHeight;
+
+    if (strokeId % 3U == 0U) {
+        strokeDurationMs = DRAG_DURATION_MS;
+        endX = nextRandom() % screenWidth;
+        endY = nextRandom() % screenHeight;
+    } else {
+        strokeDurationMs = TAP_DURATION_MS;
+        endX = startX;
+        endY = startY;
+    }
+}
+
+// Sleep until the next stroke starts
+bool SyntheticInputSource::waitForActivity(uint32_t timeoutMs) {
+    const int64_t waitUs = strokeStartUs - clock();
+
+#ifdef ARDUINO
+    if (waitUs > static_cast<int64_t>(timeoutMs) * 1000) {
+        vTaskDelay(pdMS_TO_TICKS(timeoutMs));
+        return false;
+    }
+
+    if (waitUs > 0) {
+        vTaskDelay(pdMS_TO_TICKS(waitUs / 1000) + 1);
+    }
+    return true;
+#else
+    // Host builds (tests) advance the clock themselves
+    (void)timeoutMs;
+    return waitUs <= 0;
+#endif
+}
+
+// Sample the scripted touch point
+uint8_t SyntheticInputSource::read(TouchPoint* points, uint8_t maxCount) {
+    const int64_t elapsedUs = clock() - strokeStartUs;
+    const int64_t durationUs = static_cast<int64_t>(strokeDurationMs) * 1000;
+
+    // Before the stroke
+    if (elapsedUs < 0 || maxCount == 0) {
+        return 0;
+    }
+
+    // After the stroke (released)
+    if (elapsedUs >= durationUs) {
+        nextStroke();
+        return 0;
+    }
+
+    // Interpolate along the stroke
+    points[0].x = startX + (endX - startX) * elapsedUs / durationUs;
+    points[0].y = startY + (endY - startY) * elapsedUs / durationUs;
+    points[0].id = strokeId;
+    return 1;
+}
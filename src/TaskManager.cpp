@@ -1,8 +1,10 @@
 #include "TaskManager.h"
+#include <esp_timer.h>
 
 // Constructor
-TaskManager::TaskManager(VoronoiDiagram& voronoi, TouchHandler& touch)
-    : voronoiDiagram(voronoi), touchHandler(touch) {
+TaskManager::TaskManager(VoronoiDiagram& voronoi, TouchHandler& touch, InputSource& input, BootProfiler& profiler,
+                         HeapMonitor& heap)
+    : voronoiDiagram(voronoi), touchHandler(touch), inputSource(input), bootProfiler(profiler), heapMonitor(heap) {
 }
 
 // Destructor
@@ -122,14 +124,53 @@ void TaskManager::touchTaskFunction(void* args) {
     TaskManager* self = static_cast<TaskManager*>(args);
     
     Serial.println("TouchTask started");
+    self->bootProfiler.mark("touch task started");
+
+    // Start input source (notifies this task on activity)
+    self->inputSource.begin(xTaskGetCurrentTaskHandle());
+    self->statisticsStartUs = esp_timer_get_time();
+
+    uint32_t pollIntervalMs = MIN_POLL_INTERVAL_MS;
     
     // Task main loop
     for (;;) {
+        const bool wasTouching = self->touchHandler.hasActiveTouch();
+
+        if (self->isPollingMode.load()) {
+            // Fixed polling (wait 1ms)
+            vTaskDelay(1);
+        } else if (wasTouching) {
+            // Poll at an adaptive rate while a finger is on the panel
+            vTaskDelay(pdMS_TO_TICKS(pollIntervalMs));
+        } else {
+            // Sleep until the input source signals activity
+            self->inputSource.waitForActivity(IDLE_TIMEOUT_MS);
+            pollIntervalMs = MIN_POLL_INTERVAL_MS;
+        }
+
+        self->wakeupCount.fetch_add(1);
+
         // Process touch input
-        self->touchHandler.handleInput();
+        const uint32_t eventCount = self->touchHandler.handleInput();
+
+        // Poll faster while the finger moves, slower while it rests
+        if (eventCount > 0) {
+            pollIntervalMs = MIN_POLL_INTERVAL_MS;
+        } else {
+            pollIntervalMs = (pollIntervalMs * 2U < MAX_POLL_INTERVAL_MS) ? pollIntervalMs * 2U : MAX_POLL_INTERVAL_MS;
+        }
 
-        // Prevent watchdog timeout (wait 1ms)
-        vTaskDelay(1);
+        // Measure latency from the activity signal to the first touch event
+        if (!wasTouching && self->touchHandler.hasActiveTouch()) {
+            const int64_t latencyUs = esp_timer_get_time() - self->inputSource.getLastActivityTimeUs();
+            if (latencyUs >= 0 && latencyUs < 1000000) {
+                self->touchStartCount.fetch_add(1);
+                self->totalLatencyUs.fetch_add(static_cast<uint32_t>(latencyUs));
+                if (static_cast<uint32_t>(latencyUs) > self->maxLatencyUs.load()) {
+                    self->maxLatencyUs.store(static_cast<uint32_t>(latencyUs));
+                }
+            }
+        }
     }
     
     // Delete task (should never reach here)
@@ -152,12 +193,33 @@ void TaskManager::drawTaskFunction(void* args) {
     static constexpr uint32_t DRAW_INTERVAL_MS = 10;
     
     Serial.println("Draw task started");
+
+    // Present an empty first frame, then allocate the render buffers while
+    // the screen already shows it (before the frame loop, so that neither the
+    // first tap nor the loop allocates)
+    self->voronoiDiagram.clear();
+    self->bootProfiler.mark("first frame");
+    self->voronoiDiagram.allocateBuffers();
+    self->bootProfiler.mark("buffers allocated");
+    self->bootProfiler.report(Serial);
+
+    // The frame loop must not allocate once warmed up
+    self->heapMonitor.watchCurrentTask(HEAP_WARMUP_FRAMES);
     
     // Task main loop
     for (;;) {
+        // Apply touch events
+        self->touchHandler.processEvents();
+
         // Draw Voronoi diagram
         self->voronoiDiagram.draw();
 
+        // Record or verify the frame
+        self->touchHandler.finishFrame();
+
+        // Track heap usage of the frame
+        self->heapMonitor.endFrame();
+
         // Wait for specified interval
         vTaskDelay(pdMS_TO_TICKS(DRAW_INTERVAL_MS));
     }
@@ -165,3 +227,23 @@ void TaskManager::drawTaskFunction(void* args) {
     // Delete task (should never reach here)
     vTaskDelete(nullptr);
 }
+
+// Print and reset input sampling statistics
+void TaskManager::printStatistics(Print& output) {
+    const int64_t now = esp_timer_get_time();
+    const int64_t elapsedUs = now - statisticsStartUs;
+    const uint32_t wakeups = wakeupCount.exchange(0);
+    const uint32_t touchStarts = touchStartCount.exchange(0);
+    const uint32_t totalLatency = totalLatencyUs.exchange(0);
+    const uint32_t maxLatency = maxLatencyUs.exchange(0);
+    statisticsStartUs = now;
+
+    output.printf("Input sampling (%s): %.1f wakeups/s\n",
+                  isPollingMode.load() ? "1 ms polling" : "event-driven",
+                  (elapsedUs > 0) ? wakeups * 1000000.0F / elapsedUs : 0.0F);
+
+    if (touchStarts > 0) {
+        output.printf("Touch latency: average %u us, max %u us (%u touches)\n",
+                      totalLatency / touchStarts, maxLatency, touchStarts);
+    }
+}
@@ -1,49 +1,362 @@
 #include "TouchHandler.h"
+#include <algorithm>
 
 // Constructor
-TouchHandler::TouchHandler(VoronoiDiagram& voronoi, SoundManager& sound)
-    : voronoiDiagram(voronoi), soundManager(sound) {
-}
-
-// Process touch input
-void TouchHandler::handleInput() {
-    // Update M5Stack state
-    M5.update();
-
-    // Check for touch input
-    const uint8_t touchCount = M5.Touch.getCount();
-    
-    if (touchCount > 0) {
-        // Get touch position (using first touch point)
-        m5::touch_detail_t pos = M5.Touch.getDetail(0);
-        
-        // If valid coordinates (-1, -1 are invalid coordinates)
-        const bool isValidPosition = (pos.x != -1 && pos.y != -1);
-        
-        if (isValidPosition) {
-            // Set initial touch position if not set
-            const bool isInitialTouchNotSet = (initialTouchPosition.x == -1);
-            
-            if (isInitialTouchNotSet) {
-                initialTouchPosition = pos;
+TouchHandler::TouchHandler(VoronoiModel& voronoi, SoundPlayer& sound, InputTrace& trace, InputSource& input)
+    : voronoiModel(voronoi), soundPlayer(sound), inputTrace(trace), inputSource(input) {
+    for (uint8_t i = 0; i < MAX_FINGER_COUNT; ++i) {
+        latestMoves[i].store(NO_MOVE);
+    }
+
+    resetFingers();
+}
+
+// Sample touch input, queue presses and releases, and publish moves
+uint32_t TouchHandler::handleInput() {
+    // Sample touch points
+    InputSource::TouchPoint points[MAX_FINGER_COUNT];
+    const uint8_t touchCount = inputSource.read(points, MAX_FINGER_COUNT);
+    bool isSeen[MAX_FINGER_COUNT] = {};
+    uint32_t eventCount = 0;
+
+    for (uint8_t i = 0; i < touchCount; ++i) {
+        const InputSource::TouchPoint& pos = points[i];
+
+        // Skip invalid coordinates (-1, -1 are invalid coordinates)
+        if (pos.x == -1 || pos.y == -1) {
+            continue;
+        }
+
+        // Find the finger with the same touch ID
+        int finger = -1;
+        for (uint8_t j = 0; j < MAX_FINGER_COUNT; ++j) {
+            if (sampledFingers[j].isActive && sampledFingers[j].id == pos.id) {
+                finger = j;
+                break;
             }
         }
-    } else {
-        // When touch ends
-        const bool hasPreviousTouch = (initialTouchPosition.x != -1);
-        
-        if (hasPreviousTouch) {
-            // Add point
-            voronoiDiagram.addPoint(initialTouchPosition.x, initialTouchPosition.y);
 
-            // Play feedback sound
-            soundManager.playSound(SoundManager::SoundType::TOUCH);
+        if (finger >= 0) {
+            // Touch moves (only the latest position is kept)
+            SampledFinger& sampled = sampledFingers[finger];
+            if (pos.x != sampled.x || pos.y != sampled.y) {
+                latestMoves[finger].store(packMove(sampled.generation, pos.x, pos.y));
+                sampledMoveCount.fetch_add(1);
+                ++eventCount;
+            }
+        } else {
+            // Touch starts (use a free finger slot)
+            for (uint8_t j = 0; j < MAX_FINGER_COUNT; ++j) {
+                if (!sampledFingers[j].isActive) {
+                    finger = j;
+                    break;
+                }
+            }
+
+            if (finger < 0) {
+                continue;
+            }
+
+            // Retry on the next sample if the queue is full
+            const uint8_t generation = (sampledFingers[finger].generation + 1U) & 0x7FU;
+            if (!queueEvent(InputTrace::RecordType::TOUCH_PRESS, finger, generation, pos.x, pos.y)) {
+                deferredEventCount.fetch_add(1);
+                continue;
+            }
+
+            sampledFingers[finger].isActive = true;
+            sampledFingers[finger].id = pos.id;
+            sampledFingers[finger].generation = generation;
+            ++eventCount;
+        }
+
+        sampledFingers[finger].x = pos.x;
+        sampledFingers[finger].y = pos.y;
+        isSeen[finger] = true;
+    }
+
+    // When touch ends (the finger stays active and is retried on the next sample if the queue is full)
+    for (uint8_t j = 0; j < MAX_FINGER_COUNT; ++j) {
+        SampledFinger& sampled = sampledFingers[j];
+
+        if (sampled.isActive && !isSeen[j]) {
+            if (!queueEvent(InputTrace::RecordType::TOUCH_RELEASE, j, sampled.generation, sampled.x, sampled.y)) {
+                deferredEventCount.fetch_add(1);
+                continue;
+            }
+
+            sampled.isActive = false;
+            ++eventCount;
+        }
+    }
+
+    return eventCount;
+}
+
+// Check if any finger is on the panel
+bool TouchHandler::hasActiveTouch() const {
+    for (uint8_t j = 0; j < MAX_FINGER_COUNT; ++j) {
+        if (sampledFingers[j].isActive) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Queue a press or release
+bool TouchHandler::queueEvent(InputTrace::RecordType type, uint8_t finger, uint8_t generation, int16_t x, int16_t y) {
+    const TouchEvent event = {type, finger, generation, x, y};
+
+    // Do not block the touch task (the caller retries if the queue is full)
+    return eventQueue.push(event);
+}
+
+// Pack the latest position of a finger
+uint32_t TouchHandler::packMove(uint8_t generation, int16_t x, int16_t y) {
+    // Coordinates are kept in 12 bits
+    const uint32_t packedX = static_cast<uint32_t>(std::min(std::max(static_cast<int>(x), 0), 0xFFF));
+    const uint32_t packedY = static_cast<uint32_t>(std::min(std::max(static_cast<int>(y), 0), 0xFFF));
+
+    return 0x80000000U | (static_cast<uint32_t>(generation & 0x7FU) << 24) | (packedX << 12) | packedY;
+}
+
+// Unpack the latest position of a finger
+void TouchHandler::unpackMove(uint32_t packed, uint8_t& generation, int16_t& x, int16_t& y) {
+    generation = (packed >> 24) & 0x7FU;
+    x = static_cast<int16_t>((packed >> 12) & 0xFFFU);
+    y = static_cast<int16_t>(packed & 0xFFFU);
+}
+
+// Apply queued or replayed touch events
+void TouchHandler::processEvents() {
+    // Take the latest positions before draining the queue, so that the press
+    // of every taken move is already in the queue (or applied earlier)
+    uint32_t moves[MAX_FINGER_COUNT];
+    for (uint8_t i = 0; i < MAX_FINGER_COUNT; ++i) {
+        moves[i] = latestMoves[i].exchange(NO_MOVE);
+    }
+
+    // Start or stop trace session
+    const InputTrace::Mode previousMode = inputTrace.getMode();
+    const bool isSessionStarting = inputTrace.applyPendingMode();
+    if (isSessionStarting) {
+        // Sessions start from an empty diagram
+        voronoiModel.clear();
+    }
+    if (isSessionStarting || inputTrace.getMode() != previousMode) {
+        // Touches and pins of the previous session (including the end of a replay) do not carry over
+        resetFingers();
+        voronoiModel.releaseAllPoints();
+    }
+
+    const uint32_t frame = voronoiModel.getFrameCount();
+    TouchEvent event = {};
+
+    if (inputTrace.getMode() == InputTrace::Mode::REPLAYING) {
+        // Discard live input while replaying
+        while (eventQueue.pop(event)) {
+        }
+
+        // Apply recorded events for this frame
+        while (inputTrace.nextTouch(event.type, event.finger, event.x, event.y)) {
+            applyEvent(event);
+        }
+        return;
+    }
+
+    // Collect all presses and releases received since the last frame
+    eventBatchSize = 0;
+    while (eventBatchSize < EVENT_QUEUE_LENGTH && eventQueue.pop(eventBatch[eventBatchSize])) {
+        ++eventBatchSize;
+    }
+
+    // Apply the batch in order (the diagram is recomputed once per frame)
+    for (std::size_t i = 0; i < eventBatchSize; ++i) {
+        const TouchEvent& batched = eventBatch[i];
+
+        // A release ends the touch at its last sampled position
+        if (batched.type == InputTrace::RecordType::TOUCH_RELEASE) {
+            const TouchEvent lastMove = {InputTrace::RecordType::TOUCH_MOVE, batched.finger, batched.generation,
+                                         batched.x, batched.y};
+            applyAndRecord(lastMove, frame);
+        }
+
+        applyAndRecord(batched, frame);
+    }
+
+    // Apply the latest position of every finger that is still in the same touch
+    uint32_t moveCount = 0;
+    for (uint8_t i = 0; i < MAX_FINGER_COUNT; ++i) {
+        if (moves[i] == NO_MOVE) {
+            continue;
+        }
+
+        TouchEvent latest = {InputTrace::RecordType::TOUCH_MOVE, i, 0, 0, 0};
+        unpackMove(moves[i], latest.generation, latest.x, latest.y);
+
+        if (fingers[i].isActive && fingers[i].generation == latest.generation) {
+            applyAndRecord(latest, frame);
+            ++moveCount;
+        }
+    }
+
+    if (eventBatchSize == 0 && moveCount == 0) {
+        return;
+    }
+
+    // Update statistics
+    batchFrameCount.fetch_add(1);
+    receivedEventCount.fetch_add(static_cast<uint32_t>(eventBatchSize));
+    appliedMoveCount.fetch_add(moveCount);
+    if (static_cast<uint32_t>(eventBatchSize) > maxBatchSize.load()) {
+        maxBatchSize.store(static_cast<uint32_t>(eventBatchSize));
+    }
+}
 
-            // Draw Voronoi diagram
-            voronoiDiagram.draw();
+// Apply and record a touch event
+void TouchHandler::applyAndRecord(const TouchEvent& event, uint32_t frame) {
+    inputTrace.recordTouch(event.type, frame, event.finger, event.x, event.y);
+    applyEvent(event);
+}
+
+// Apply a touch event to the Voronoi model
+void TouchHandler::applyEvent(const TouchEvent& event) {
+    if (event.finger >= MAX_FINGER_COUNT) {
+        return;
+    }
+
+    FingerState& finger = fingers[event.finger];
+
+    switch (event.type) {
+        case InputTrace::RecordType::TOUCH_PRESS:
+            // A press without a release of the previous touch drops its point
+            if (finger.isActive && finger.isDragging) {
+                voronoiModel.releasePoint(finger.pointIndex);
+            }
+
+            // Set initial touch position
+            finger.isActive = true;
+            finger.isDragging = false;
+            finger.generation = event.generation;
+            finger.initialX = event.x;
+            finger.initialY = event.y;
+            finger.pointIndex = -1;
+            break;
+        case InputTrace::RecordType::TOUCH_MOVE: {
+            if (!finger.isActive) {
+                break;
+            }
+
+            // Grab the point of the touched cell once the drag threshold is exceeded
+            if (!finger.isDragging) {
+                const int dx = event.x - finger.initialX;
+                const int dy = event.y - finger.initialY;
+                const bool isDrag = (dx * dx + dy * dy > DRAG_THRESHOLD * DRAG_THRESHOLD);
+
+                if (!isDrag) {
+                    break;
+                }
+
+                finger.isDragging = true;
+                finger.pointIndex = voronoiModel.findPointAt(finger.initialX, finger.initialY);
 
-            // Reset touch position (set to invalid coordinates)
-            initialTouchPosition = {};
+                // A point follows only one finger
+                for (uint8_t i = 0; i < MAX_FINGER_COUNT; ++i) {
+                    if (i != event.finger && fingers[i].isDragging && fingers[i].pointIndex == finger.pointIndex) {
+                        finger.pointIndex = -1;
+                    }
+                }
+            }
+
+            // Dragged point follows the finger
+            if (finger.pointIndex >= 0) {
+                voronoiModel.movePoint(finger.pointIndex, event.x, event.y);
+            }
+            break;
         }
+        case InputTrace::RecordType::TOUCH_RELEASE:
+            if (!finger.isActive) {
+                break;
+            }
+
+            if (finger.isDragging) {
+                // Drop the dragged point
+                voronoiModel.releasePoint(finger.pointIndex);
+            } else {
+                // Add point
+                addPoint(finger.initialX, finger.initialY);
+
+                // Play feedback sound
+                soundPlayer.playSound(SoundPlayer::SoundType::TOUCH);
+            }
+
+            finger = {};
+            finger.pointIndex = -1;
+            break;
+        default:
+            break;
+    }
+}
+
+// Add a point and fix up indices of dragged points
+void TouchHandler::addPoint(int x, int y) {
+    if (!voronoiModel.addPoint(x, y)) {
+        return;
+    }
+
+    // Play eviction sound
+    soundPlayer.playSound(SoundPlayer::SoundType::EVICTION);
+
+    // The oldest point was removed, so point indices shift down by one
+    for (uint8_t i = 0; i < MAX_FINGER_COUNT; ++i) {
+        if (fingers[i].pointIndex >= 0) {
+            --fingers[i].pointIndex;
+        }
+    }
+}
+
+// Reset finger states on the processing side
+void TouchHandler::resetFingers() {
+    for (uint8_t i = 0; i < MAX_FINGER_COUNT; ++i) {
+        fingers[i] = {};
+        fingers[i].pointIndex = -1;
+    }
+}
+
+// Record or verify the frame just drawn
+void TouchHandler::finishFrame() {
+    const InputTrace::Mode mode = inputTrace.getMode();
+    if (mode == InputTrace::Mode::IDLE) {
+        return;
+    }
+
+    const uint32_t frame = voronoiModel.getFrameCount() - 1U;
+    const uint32_t hash = voronoiModel.computeFrameHash();
+
+    if (mode == InputTrace::Mode::RECORDING) {
+        inputTrace.recordFrameHash(frame, hash);
+    } else {
+        inputTrace.checkFrameHash(frame, hash);
+    }
+}
+
+// Print and reset event batch statistics
+void TouchHandler::printStatistics(Print& output) {
+    // Take a snapshot, since the draw and touch tasks keep counting
+    const uint32_t batchFrames = batchFrameCount.exchange(0);
+    const uint32_t receivedEvents = receivedEventCount.exchange(0);
+    const uint32_t appliedMoves = appliedMoveCount.exchange(0);
+    const uint32_t maxBatch = maxBatchSize.exchange(0);
+    const uint32_t sampledMoves = sampledMoveCount.exchange(0);
+    const uint32_t deferredEvents = deferredEventCount.exchange(0);
+
+    output.printf("Touch event batches: %u frames, %u presses/releases received, %u deferred by a full queue\n",
+                  batchFrames, receivedEvents, deferredEvents);
+    output.printf("Touch moves: %u sampled, %u applied after coalescing\n", sampledMoves, appliedMoves);
+
+    if (batchFrames > 0) {
+        output.printf("Presses/releases per batch: average %.2f, max %u\n",
+                      (float)receivedEvents / batchFrames, maxBatch);
     }
 }
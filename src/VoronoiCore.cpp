@@ -0,0 +1,182 @@
+#include "VoronoiCore.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Get index of the nearest point
+int VoronoiCore::getNearestPointIndex(const Point* points, std::size_t count, int x, int y) {
+    if (count == 0) {
+        return -1;
+    }
+
+    int nearestIndex = 0;
+    int nearestDistSquared = INT_MAX;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        // Calculate squared Euclidean distance (avoid square root calculation)
+        const int dx = x - points[i].x;
+        const int dy = y - points[i].y;
+        const int distSquared = dx * dx + dy * dy;
+
+        if (distSquared < nearestDistSquared) {
+            nearestDistSquared = distSquared;
+            nearestIndex = static_cast<int>(i);
+        }
+    }
+
+    return nearestIndex;
+}
+
+// Execute Jump Flooding Algorithm
+void VoronoiCore::executeJFA(const Point* points, std::size_t count, int width, int height,
+                             SeedPoint* bufferA, SeedPoint* bufferB) {
+    const int pixelCount = width * height;
+
+    // Initialize buffers
+    for (int idx = 0; idx < pixelCount; ++idx) {
+        bufferA[idx].x = -1;
+        bufferA[idx].y = -1;
+        bufferA[idx].idx = -1;
+    }
+
+    // Set seed points
+    for (std::size_t i = 0; i < count; ++i) {
+        const int x = points[i].x;
+        const int y = points[i].y;
+
+        if (x >= 0 && x < width && y >= 0 && y < height) {
+            const int idx = y * width + x;
+            bufferA[idx].x = x;
+            bufferA[idx].y = y;
+            bufferA[idx].idx = i;
+        }
+    }
+
+    // Jump flooding steps
+    SeedPoint* srcBuffer = bufferA;
+    SeedPoint* dstBuffer = bufferB;
+
+    // Start with the largest power of two below the longer side so that every
+    // pixel is reachable, and reduce by half each iteration
+    int initialStep = 1;
+    while (initialStep * 2 < std::max(width, height)) {
+        initialStep *= 2;
+    }
+
+    for (int step = initialStep; step > 0; step /= 2) {
+        // For each pixel
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                const int idx = y * width + x;
+
+                // Copy current value to destination buffer
+                dstBuffer[idx] = srcBuffer[idx];
+
+                // Check 8 neighboring pixels at distance 'step'
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        const int nx = x + dx * step;
+                        const int ny = y + dy * step;
+
+                        // Skip if outside screen
+                        if (nx < 0 || nx >= width || ny < 0 || ny >= height) {
+                            continue;
+                        }
+
+                        const SeedPoint& neighbor = srcBuffer[ny * width + nx];
+
+                        // Skip if neighbor has no seed point
+                        if (neighbor.idx < 0) {
+                            continue;
+                        }
+
+                        // Calculate distance to neighbor's seed point
+                        const int dx1 = x - neighbor.x;
+                        const int dy1 = y - neighbor.y;
+                        const int distSquared1 = dx1 * dx1 + dy1 * dy1;
+
+                        // Calculate distance to current seed point (if any)
+                        int distSquared2 = INT_MAX;
+                        if (dstBuffer[idx].idx >= 0) {
+                            const int dx2 = x - dstBuffer[idx].x;
+                            const int dy2 = y - dstBuffer[idx].y;
+                            distSquared2 = dx2 * dx2 + dy2 * dy2;
+                        }
+
+                        // Update if neighbor's seed point is closer
+                        if (distSquared1 < distSquared2) {
+                            dstBuffer[idx] = neighbor;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Swap buffers for next iteration
+        std::swap(srcBuffer, dstBuffer);
+    }
+
+    // Ensure final result is in bufferA
+    if (srcBuffer != bufferA) {
+        memcpy(bufferA, srcBuffer, pixelCount * sizeof(SeedPoint));
+    }
+}
+
+// Get mask of points moved against the previous positions
+uint32_t VoronoiCore::getMovedPointMask(const Point* points, const Point* previous, std::size_t count) {
+    uint32_t movedMask = 0;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (points[i].x != previous[i].x || points[i].y != previous[i].y) {
+            movedMask |= (1U << i);
+        }
+    }
+
+    return movedMask;
+}
+
+// Push points apart within the repulsion radius
+void VoronoiCore::applyRepulsiveForce(Point* points, std::size_t count, uint32_t pinnedMask,
+                                      int maxX, int maxY, Force* forces) {
+    const float radiusSquared = REPULSION_RADIUS * REPULSION_RADIUS;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        forces[i] = {0.0f, 0.0f};
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::size_t j = i + 1; j < count; ++j) {
+            // Calculate distance and direction between points
+            const int dx = points[i].x - points[j].x;
+            const int dy = points[i].y - points[j].y;
+            const float distSquared = dx * dx + dy * dy;
+
+            // Apply repulsive force if within certain radius
+            if (distSquared > 0 && distSquared < radiusSquared) {
+                const float dist = sqrtf(distSquared); // Calculate square root only here
+                const float force = REPULSION_STRENGTH / distSquared; // Divide by square of distance
+
+                const float fx = force * (dx / dist);
+                const float fy = force * (dy / dist);
+
+                // Apply force to both points (action-reaction)
+                forces[i].x += fx;
+                forces[i].y += fy;
+                forces[j].x -= fx;
+                forces[j].y -= fy;
+            }
+        }
+    }
+
+    // Apply calculated forces to move points (pinned points follow the finger instead)
+    for (std::size_t i = 0; i < count; ++i) {
+        if (pinnedMask & (1U << i)) {
+            continue;
+        }
+
+        const int x = static_cast<int>(points[i].x + forces[i].x);
+        const int y = static_cast<int>(points[i].y + forces[i].y);
+        points[i].x = (x < 0) ? 0 : ((x > maxX) ? maxX : x);
+        points[i].y = (y < 0) ? 0 : ((y > maxY) ? maxY : y);
+    }
+}
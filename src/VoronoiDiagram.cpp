@@ -1,39 +1,6 @@
 #include "VoronoiDiagram.h"
-#include <esp_random.h>
+#include "LabelStream.h"
 #include <algorithm>
-#include <esp_log.h>
-
-// Custom clamp function (since std::clamp requires C++17)
-template<typename T>
-T clamp(const T& value, const T& min, const T& max) {
-    return (value < min) ? min : ((value > max) ? max : value);
-}
-
-static const char* TAG = "VoronoiDiagram";
-
-// Define color palette
-const uint16_t VoronoiDiagram::COLOR_PALETTE[20] = {
-    0xED79, // RGB(238, 175, 206)
-    0xFDB8, // RGB(251, 180, 196)
-    0xFDB6, // RGB(250, 182, 181)
-    0xFE76, // RGB(253, 205, 183)
-    0xFED6, // RGB(251, 216, 176)
-    0xFF35, // RGB(254, 230, 170)
-    0xFF95, // RGB(252, 241, 175)
-    0xFFF6, // RGB(254, 255, 179)
-    0xEFD6, // RGB(238, 250, 178)
-    0xE7F6, // RGB(230, 245, 176)
-    0xDFB8, // RGB(217, 246, 192)
-    0xCF58, // RGB(204, 234, 196)
-    0xC759, // RGB(192, 235, 205)
-    0xB71B, // RGB(179, 226, 216)
-    0xB6FB, // RGB(180, 221, 223)
-    0xB6BB, // RGB(180, 215, 221)
-    0xB69C, // RGB(181, 210, 224)
-    0xB67C, // RGB(179, 206, 227)
-    0xB61B, // RGB(180, 194, 221)
-    0xB5BB  // RGB(178, 182, 217)
-};
 
 // Mutex lock class using RAII pattern
 class MutexLock {
@@ -56,303 +23,135 @@ private:
 };
 
 // Constructor
-VoronoiDiagram::VoronoiDiagram(M5Canvas& buffer, SemaphoreHandle_t mutex)
-    : screenBuffer(buffer), drawMutex(mutex) {
-    // Pre-allocate memory for point list
-    points.reserve(MAX_POINT_COUNT);
-    
-    // Get screen dimensions
-    screenWidth = M5.Display.width();
-    screenHeight = M5.Display.height();
-    screenSize = screenWidth * screenHeight;
-    
-    // Initialize JFA buffers in PSRAM
-    initJFABuffers();
+VoronoiDiagram::VoronoiDiagram(VoronoiModel& voronoiModel, M5Canvas& buffer, SemaphoreHandle_t mutex)
+    : model(voronoiModel), screenBuffer(buffer), drawMutex(mutex) {
+    // JFA buffers and label map are allocated by allocateBuffers() after the
+    // first frame is shown, so that they do not delay it
 }
 
-// Destructor
-VoronoiDiagram::~VoronoiDiagram() {
-    // Free JFA buffers
-    freeJFABuffers();
-}
+// Allocate JFA buffers and label map
+void VoronoiDiagram::allocateBuffers() {
+    MutexLock lock(drawMutex);
+    if (!lock.isLocked()) {
+        return;
+    }
 
-// Initialize JFA buffers in internal SRAM
-void VoronoiDiagram::initJFABuffers() {
-    // Free existing buffers if any
-    freeJFABuffers();
-    
-    // Try to allocate buffers in internal SRAM (DMA capable memory for faster access)
-    jfaBufferA = (SeedPoint*)heap_caps_malloc(screenSize * sizeof(SeedPoint), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
-    jfaBufferB = (SeedPoint*)heap_caps_malloc(screenSize * sizeof(SeedPoint), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+    model.allocateBuffers();
 }
 
-// Free JFA buffers
-void VoronoiDiagram::freeJFABuffers() {
-    if (jfaBufferA) {
-        free(jfaBufferA);
-        jfaBufferA = nullptr;
-    }
-    
-    if (jfaBufferB) {
-        free(jfaBufferB);
-        jfaBufferB = nullptr;
+// Remove all points and clear the screen
+void VoronoiDiagram::clear() {
+    MutexLock lock(drawMutex);
+    if (!lock.isLocked()) {
+        return;
     }
-}
 
-// Add a point
-void VoronoiDiagram::addPoint(int x, int y) {
-    // Adjust coordinates if outside screen
-    x = clamp(x, 0, (int)M5.Display.width());
-    y = clamp(y, 0, (int)M5.Display.height());
-
-    // If exceeding maximum number of points, remove the first point
-    if (points.size() >= MAX_POINT_COUNT) {
-        points.erase(points.begin());
-    }
+    model.clear();
+    drawnPointCount = 0;
 
-    // Randomly select a color from the palette
-    const uint16_t color = COLOR_PALETTE[esp_random() % (sizeof(COLOR_PALETTE) / sizeof(COLOR_PALETTE[0]))];
+    screenBuffer.fillScreen(BLACK);
+    screenBuffer.pushSprite(&M5.Display, 0, 0);
+}
 
-    // Add new point to the list
-    points.push_back({x, y, color});
+// Compute label map for the given points
+bool VoronoiDiagram::computeLabels(const Point* seeds, std::size_t count, RenderPath path, int16_t* labels) {
+    if (path != RenderPath::JFA) {
+        return model.computeLabels(seeds, count, path, labels);
+    }
 
-    // Draw a white circle at the point position
+    // The JFA buffers are shared with the draw task
     MutexLock lock(drawMutex);
     if (!lock.isLocked()) {
-        return;
+        return false;
     }
-    
-    M5.Display.fillCircle(x, y, 3, WHITE);
+
+    return model.computeLabels(seeds, count, path, labels);
 }
 
 // Draw Voronoi diagram
 void VoronoiDiagram::draw() {
-    // Do nothing if there are no points
-    if (points.empty()) {
-        return;
-    }
-
     // Lock mutex to prevent other tasks from drawing
     MutexLock lock(drawMutex);
     if (!lock.isLocked()) {
         return;
     }
 
-    // Apply repulsive force to move points
-    applyRepulsiveForce();
+    // Move the points and relabel the pixels, painting every relabeled pixel
+    const Point* current = model.getPoints();
+    M5Canvas& canvas = screenBuffer;
+    const VoronoiModel::StepResult result = model.step(
+        [current, &canvas](int x, int y, int index) { canvas.drawPixel(x, y, current[index].color); });
+
+    const uint32_t frame = model.getFrameCount() - 1;
+
+    // Without points, clear the screen once (the stream still mirrors the empty screen)
+    if (result == VoronoiModel::StepResult::EMPTY) {
+        if (drawnPointCount > 0) {
+            screenBuffer.fillScreen(BLACK);
+            screenBuffer.pushSprite(&M5.Display, 0, 0);
+            drawnPointCount = 0;
+        }
+        if (labelStream) {
+            labelStream->encodeFrame(frame, nullptr, nullptr, 0);
+        }
+        return;
+    }
+
+    // An incremental step repaints only relabeled pixels, so restore the cells under the old circles
+    if (result == VoronoiModel::StepResult::INCREMENTAL) {
+        repaintPreviousPoints();
+    }
 
-    // Draw Voronoi diagram
-    renderVoronoiDiagram();
-    
     // Draw points
     renderPoints();
 
+    // Stream the label map of this frame
+    if (labelStream) {
+        labelStream->encodeFrame(frame, model.getLabelMap(), model.getPoints(), model.getPointCount());
+    }
+
     // Push off-screen buffer to display
     screenBuffer.pushSprite(&M5.Display, 0, 0);
 }
 
-// Render Voronoi diagram using Jump Flooding Algorithm
-void VoronoiDiagram::renderVoronoiDiagram() {
-    // Check if buffers are available
-    if (!jfaBufferA || !jfaBufferB || points.empty()) {
-        // Fallback to traditional method if buffers are not available
-        const int width = screenWidth;
-        const int height = screenHeight;
-
-        for (int y = 0; y < height; ++y) {
-            for (int x = 0; x < width; ++x) {
-                int nearestIndex = getNearestPointIndex(x, y);
-                if (nearestIndex != -1) {
-                    screenBuffer.drawPixel(x, y, points[nearestIndex].color);
-                }
-            }
-        }
+// Repaint the areas under the previously drawn point circles
+void VoronoiDiagram::repaintPreviousPoints() {
+    const uint8_t* labelMap = model.getLabelMap();
+    if (!labelMap) {
         return;
     }
 
-    // Execute Jump Flooding Algorithm
-    executeJFA();
+    const Point* points = model.getPoints();
+    const int numPoints = static_cast<int>(model.getPointCount());
+    const int width = model.getWidth();
+    const int height = model.getHeight();
 
-    // Render the result to the screen buffer
-    for (int y = 0; y < screenHeight; ++y) {
-        for (int x = 0; x < screenWidth; ++x) {
-            const int idx = y * screenWidth + x;
-            const int pointIdx = jfaBufferA[idx].idx;
-            
-            if (pointIdx >= 0 && pointIdx < static_cast<int>(points.size())) {
-                screenBuffer.drawPixel(x, y, points[pointIdx].color);
-            }
-        }
-    }
-}
+    for (std::size_t i = 0; i < drawnPointCount; ++i) {
+        const int minX = std::max(drawnPoints[i].x - POINT_RADIUS, 0);
+        const int maxX = std::min(drawnPoints[i].x + POINT_RADIUS, width - 1);
+        const int minY = std::max(drawnPoints[i].y - POINT_RADIUS, 0);
+        const int maxY = std::min(drawnPoints[i].y + POINT_RADIUS, height - 1);
 
-// Execute Jump Flooding Algorithm
-void VoronoiDiagram::executeJFA() {
-    const int width = screenWidth;
-    const int height = screenHeight;
-    const size_t numPoints = points.size();
-    
-    // Initialize buffers
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            const int idx = y * width + x;
-            jfaBufferA[idx].x = -1;
-            jfaBufferA[idx].y = -1;
-            jfaBufferA[idx].idx = -1;
-        }
-    }
-    
-    // Set seed points
-    for (size_t i = 0; i < numPoints; ++i) {
-        const int x = points[i].x;
-        const int y = points[i].y;
-        
-        if (x >= 0 && x < width && y >= 0 && y < height) {
-            const int idx = y * width + x;
-            jfaBufferA[idx].x = x;
-            jfaBufferA[idx].y = y;
-            jfaBufferA[idx].idx = i;
-        }
-    }
-    
-    // Jump flooding steps
-    SeedPoint* srcBuffer = jfaBufferA;
-    SeedPoint* dstBuffer = jfaBufferB;
-    
-    // Start with step size = width/2 and reduce by half each iteration
-    for (int step = width / 2; step > 0; step /= 2) {
-        // For each pixel
-        for (int y = 0; y < height; ++y) {
-            for (int x = 0; x < width; ++x) {
-                const int idx = y * width + x;
-                const SeedPoint& current = srcBuffer[idx];
-                
-                // Copy current value to destination buffer
-                dstBuffer[idx] = current;
-                
-                // Check 8 neighboring pixels at distance 'step'
-                for (int dy = -1; dy <= 1; ++dy) {
-                    for (int dx = -1; dx <= 1; ++dx) {
-                        const int nx = x + dx * step;
-                        const int ny = y + dy * step;
-                        
-                        // Skip if outside screen
-                        if (nx < 0 || nx >= width || ny < 0 || ny >= height) {
-                            continue;
-                        }
-                        
-                        const int nidx = ny * width + nx;
-                        const SeedPoint& neighbor = srcBuffer[nidx];
-                        
-                        // Skip if neighbor has no seed point
-                        if (neighbor.idx < 0) {
-                            continue;
-                        }
-                        
-                        // Calculate distance to neighbor's seed point
-                        int dx1 = x - neighbor.x;
-                        int dy1 = y - neighbor.y;
-                        int distSquared1 = dx1 * dx1 + dy1 * dy1;
-                        
-                        // Calculate distance to current seed point (if any)
-                        int distSquared2 = INT_MAX;
-                        if (dstBuffer[idx].idx >= 0) {
-                            int dx2 = x - dstBuffer[idx].x;
-                            int dy2 = y - dstBuffer[idx].y;
-                            distSquared2 = dx2 * dx2 + dy2 * dy2;
-                        }
-                        
-                        // Update if neighbor's seed point is closer
-                        if (distSquared1 < distSquared2) {
-                            dstBuffer[idx] = neighbor;
-                        }
-                    }
+        for (int y = minY; y <= maxY; ++y) {
+            for (int x = minX; x <= maxX; ++x) {
+                const int label = labelMap[y * width + x];
+                if (label < numPoints) {
+                    screenBuffer.drawPixel(x, y, points[label].color);
                 }
             }
         }
-        
-        // Swap buffers for next iteration
-        std::swap(srcBuffer, dstBuffer);
-    }
-    
-    // Ensure final result is in jfaBufferA
-    if (srcBuffer != jfaBufferA) {
-        memcpy(jfaBufferA, srcBuffer, screenSize * sizeof(SeedPoint));
     }
 }
 
 // Draw points
 void VoronoiDiagram::renderPoints() {
-    const size_t numPoints = points.size();
-    
-    // Draw white circles at point positions
-    for (size_t i = 0; i < numPoints; ++i) {
-        screenBuffer.fillCircle(points[i].x, points[i].y, 3, WHITE);
-    }
-}
-
-// Apply repulsive force to move points
-void VoronoiDiagram::applyRepulsiveForce() {
-    const size_t numPoints = points.size();
-    const float radiusSquared = REPULSION_RADIUS * REPULSION_RADIUS;
-    const int displayWidth = M5.Display.width();
-    const int displayHeight = M5.Display.height();
-    
-    // Calculate forces for each point
-    std::vector<std::pair<float, float>> forces(numPoints, {0.0f, 0.0f});
-    
-    for (size_t i = 0; i < numPoints; ++i) {
-        for (size_t j = i + 1; j < numPoints; ++j) {
-            // Calculate distance and direction between points
-            int dx = points[i].x - points[j].x;
-            int dy = points[i].y - points[j].y;
-            float distSquared = dx * dx + dy * dy;
-            
-            // Apply repulsive force if within certain radius
-            if (distSquared > 0 && distSquared < radiusSquared) {
-                float dist = sqrtf(distSquared); // Calculate square root only here
-                float force = REPULSION_STRENGTH / distSquared; // Divide by square of distance
-                
-                float fx = force * (dx / dist);
-                float fy = force * (dy / dist);
-                
-                // Apply force to both points (action-reaction)
-                forces[i].first += fx;
-                forces[i].second += fy;
-                forces[j].first -= fx;
-                forces[j].second -= fy;
-            }
-        }
-    }
+    const Point* points = model.getPoints();
+    const size_t numPoints = model.getPointCount();
     
-    // Apply calculated forces to move points
+    // Draw white circles at point positions (remembered for the next incremental repaint)
     for (size_t i = 0; i < numPoints; ++i) {
-        points[i].x = clamp((int)(points[i].x + forces[i].first), 0, displayWidth);
-        points[i].y = clamp((int)(points[i].y + forces[i].second), 0, displayHeight);
+        screenBuffer.fillCircle(points[i].x, points[i].y, POINT_RADIUS, WHITE);
+        drawnPoints[i] = points[i];
     }
-}
-
-// Get index of the nearest point
-int VoronoiDiagram::getNearestPointIndex(int x, int y) const {
-    if (points.empty()) {
-        return -1;
-    }
-    
-    int nearestIndex = 0;
-    int nearestDistSquared = INT_MAX;
-    const size_t numPoints = points.size();
-
-    for (size_t i = 0; i < numPoints; ++i) {
-    // Calculate squared Euclidean distance (avoid square root calculation)
-        int dx = x - points[i].x;
-        int dy = y - points[i].y;
-        int distSquared = dx * dx + dy * dy;
-
-        if (distSquared < nearestDistSquared) {
-            nearestDistSquared = distSquared;
-            nearestIndex = i;
-        }
-    }
-
-    return nearestIndex;
+    drawnPointCount = numPoints;
 }
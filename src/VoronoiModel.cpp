@@ -0,0 +1,312 @@
+#include "VoronoiModel.h"
+#include "InputTrace.h"
+#include <algorithm>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#else
+#include <cstdio>
+#include <cstdlib>
+#endif
+
+// Custom clamp function (since std::clamp requires C++17)
+template<typename T>
+static T clamp(const T& value, const T& min, const T& max) {
+    return (value < min) ? min : ((value > max) ? max : value);
+}
+
+// Memory capabilities of the buffers (host builds ignore them)
+#ifdef ARDUINO
+static const uint32_t JFA_BUFFER_CAPS = MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA;
+static const uint32_t LABEL_MAP_CAPS = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+static const uint32_t FALLBACK_CAPS = MALLOC_CAP_SPIRAM;
+#else
+static const uint32_t JFA_BUFFER_CAPS = 0;
+static const uint32_t LABEL_MAP_CAPS = 0;
+static const uint32_t FALLBACK_CAPS = 0;
+#endif
+
+// Allocate a buffer with the given capabilities
+static void* allocateBuffer(std::size_t size, uint32_t caps) {
+#ifdef ARDUINO
+    return heap_caps_malloc(size, caps);
+#else
+    // Host builds (tests)
+    (void)caps;
+    return malloc(size);
+#endif
+}
+
+// Free a buffer allocated by allocateBuffer()
+template<typename T>
+static void freeBuffer(T*& buffer) {
+    if (buffer) {
+#ifdef ARDUINO
+        heap_caps_free(buffer);
+#else
+        free(buffer);
+#endif
+        buffer = nullptr;
+    }
+}
+
+// Report an allocation failure
+static void reportFailure(const char* message) {
+#ifdef ARDUINO
+    Serial.println(message);
+#else
+    fprintf(stderr, "%s\n", message);
+#endif
+}
+
+// Define color palette
+const uint16_t VoronoiModel::COLOR_PALETTE[20] = {
+    0xED79, // RGB(238, 175, 206)
+    0xFDB8, // RGB(251, 180, 196)
+    0xFDB6, // RGB(250, 182, 181)
+    0xFE76, // RGB(253, 205, 183)
+    0xFED6, // RGB(251, 216, 176)
+    0xFF35, // RGB(254, 230, 170)
+    0xFF95, // RGB(252, 241, 175)
+    0xFFF6, // RGB(254, 255, 179)
+    0xEFD6, // RGB(238, 250, 178)
+    0xE7F6, // RGB(230, 245, 176)
+    0xDFB8, // RGB(217, 246, 192)
+    0xCF58, // RGB(204, 234, 196)
+    0xC759, // RGB(192, 235, 205)
+    0xB71B, // RGB(179, 226, 216)
+    0xB6FB, // RGB(180, 221, 223)
+    0xB6BB, // RGB(180, 215, 221)
+    0xB69C, // RGB(181, 210, 224)
+    0xB67C, // RGB(179, 206, 227)
+    0xB61B, // RGB(180, 194, 221)
+    0xB5BB  // RGB(178, 182, 217)
+};
+
+// Constructor
+VoronoiModel::VoronoiModel(int width, int height, RandomFunction randomFunction)
+    : random(randomFunction), screenWidth(width), screenHeight(height), screenSize(width * height) {
+    // Pre-allocate memory for point list
+    points.reserve(MAX_POINT_COUNT);
+}
+
+// Destructor
+VoronoiModel::~VoronoiModel() {
+    freeBuffers();
+}
+
+// Allocate JFA buffers and label map
+bool VoronoiModel::allocateBuffers() {
+    if (labelMap) {
+        return true;
+    }
+
+    const std::size_t jfaBufferSize = screenSize * sizeof(SeedPoint);
+
+    // Try to allocate JFA buffers in internal SRAM (DMA capable memory for faster access)
+    jfaBufferA = static_cast<SeedPoint*>(allocateBuffer(jfaBufferSize, JFA_BUFFER_CAPS));
+    jfaBufferB = static_cast<SeedPoint*>(allocateBuffer(jfaBufferSize, JFA_BUFFER_CAPS));
+
+    // Two full-screen buffers rarely fit in internal SRAM, so use PSRAM for both
+    if (!jfaBufferA || !jfaBufferB) {
+        freeBuffer(jfaBufferA);
+        freeBuffer(jfaBufferB);
+        jfaBufferA = static_cast<SeedPoint*>(allocateBuffer(jfaBufferSize, FALLBACK_CAPS));
+        jfaBufferB = static_cast<SeedPoint*>(allocateBuffer(jfaBufferSize, FALLBACK_CAPS));
+    }
+
+    if (!jfaBufferA || !jfaBufferB) {
+        reportFailure("Failed to allocate JFA buffers");
+        freeBuffer(jfaBufferA);
+        freeBuffer(jfaBufferB);
+    }
+
+    // Label map in internal SRAM (with fallback to PSRAM)
+    labelMap = static_cast<uint8_t*>(allocateBuffer(screenSize, LABEL_MAP_CAPS));
+    if (!labelMap) {
+        labelMap = static_cast<uint8_t*>(allocateBuffer(screenSize, FALLBACK_CAPS));
+    }
+    if (!labelMap) {
+        reportFailure("Failed to allocate label map");
+    }
+    isLabelMapValid = false;
+
+    return labelMap != nullptr;
+}
+
+// Free JFA buffers and label map
+void VoronoiModel::freeBuffers() {
+    freeBuffer(jfaBufferA);
+    freeBuffer(jfaBufferB);
+    freeBuffer(labelMap);
+    isLabelMapValid = false;
+}
+
+// Add a point
+bool VoronoiModel::addPoint(int x, int y) {
+    // Adjust coordinates if outside screen
+    x = clamp(x, 0, screenWidth);
+    y = clamp(y, 0, screenHeight);
+
+    // If exceeding maximum number of points, remove the first point
+    const bool isEvicting = (points.size() >= MAX_POINT_COUNT);
+    if (isEvicting) {
+        points.erase(points.begin());
+
+        // Point indices shift down by one
+        pinnedMask >>= 1;
+    }
+
+    // Randomly select a color from the palette
+    const uint16_t color = COLOR_PALETTE[nextRandom() % (sizeof(COLOR_PALETTE) / sizeof(COLOR_PALETTE[0]))];
+
+    // Add new point to the list
+    points.push_back({x, y, color});
+
+    // Label map no longer matches the point list
+    isLabelMapValid = false;
+
+    return isEvicting;
+}
+
+// Get index of the point whose cell contains the position
+int VoronoiModel::findPointAt(int x, int y) const {
+    x = clamp(x, 0, screenWidth - 1);
+    y = clamp(y, 0, screenHeight - 1);
+
+    // Look up the label map of the last frame
+    if (labelMap && isLabelMapValid) {
+        const int label = labelMap[y * screenWidth + x];
+        if (label < static_cast<int>(points.size())) {
+            return label;
+        }
+    }
+
+    // Fallback to nearest point search
+    return getNearestPointIndex(x, y);
+}
+
+// Move a point and pin it against the repulsive force
+void VoronoiModel::movePoint(int index, int x, int y) {
+    if (index < 0 || index >= static_cast<int>(points.size())) {
+        return;
+    }
+
+    points[index].x = clamp(x, 0, screenWidth);
+    points[index].y = clamp(y, 0, screenHeight);
+    pinnedMask |= (1U << index);
+}
+
+// Release a pinned point
+void VoronoiModel::releasePoint(int index) {
+    if (index < 0 || index >= static_cast<int>(MAX_POINT_COUNT)) {
+        return;
+    }
+
+    pinnedMask &= ~(1U << index);
+}
+
+// Draw a random value
+uint32_t VoronoiModel::nextRandom() {
+    uint32_t value = 0;
+
+    // Use the recorded value when replaying
+    if (inputTrace && inputTrace->nextRandom(value)) {
+        return value;
+    }
+
+    value = random();
+
+    // Record the value when recording
+    if (inputTrace) {
+        inputTrace->recordRandom(value);
+    }
+
+    return value;
+}
+
+// Remove all points
+void VoronoiModel::clear() {
+    points.clear();
+    frameCount = 0;
+    pinnedMask = 0;
+    isLabelMapValid = false;
+}
+
+// Compute hash of the label map and the points (FNV-1a)
+uint32_t VoronoiModel::computeFrameHash() const {
+    uint32_t hash = 2166136261U;
+
+    // Label map (skipped until a step has labeled the current points)
+    const uint8_t* labels = getLabelMap();
+    if (labels) {
+        for (int i = 0; i < screenSize; ++i) {
+            hash = (hash ^ labels[i]) * 16777619U;
+        }
+    }
+
+    // Point positions and colors
+    for (const Point& point : points) {
+        const uint32_t fields[3] = {static_cast<uint32_t>(point.x), static_cast<uint32_t>(point.y), point.color};
+        for (uint32_t field : fields) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                hash = (hash ^ ((field >> shift) & 0xFFU)) * 16777619U;
+            }
+        }
+    }
+
+    return hash;
+}
+
+// Compute label map for the given points
+bool VoronoiModel::computeLabels(const Point* seeds, std::size_t count, RenderPath path, int16_t* labels) {
+    if (!seeds || !labels) {
+        return false;
+    }
+
+    switch (path) {
+        case RenderPath::BRUTE_FORCE:
+            VoronoiCore::computeBruteForce(seeds, count, screenWidth, screenHeight, labels, VoronoiCore::NoPaint());
+            return true;
+        case RenderPath::JFA:
+            // Skipped until allocateBuffers() has run
+            if (count == 0 || !jfaBufferA || !jfaBufferB) {
+                return false;
+            }
+
+            VoronoiCore::executeJFA(seeds, count, screenWidth, screenHeight, jfaBufferA, jfaBufferB);
+            for (int i = 0; i < screenSize; ++i) {
+                labels[i] = jfaBufferA[i].idx;
+            }
+            return true;
+        case RenderPath::INCREMENTAL:
+            // Needs the label map of the previous points (use updateLabels())
+            return false;
+    }
+
+    return false;
+}
+
+// Update a label map computed for the previous points to the given points
+bool VoronoiModel::updateLabels(const Point* previous, const Point* seeds, std::size_t count, int16_t* labels) const {
+    if (!previous || !seeds || !labels || count > VoronoiCore::MAX_POINT_COUNT) {
+        return false;
+    }
+
+    const uint32_t movedMask = VoronoiCore::getMovedPointMask(seeds, previous, count);
+    VoronoiCore::updateMovedLabels(seeds, count, movedMask, screenWidth, screenHeight, labels, VoronoiCore::NoPaint());
+
+    return true;
+}
+
+// Apply repulsive force to move points
+void VoronoiModel::applyRepulsiveForce() {
+    // Scratch memory for the forces comes from the frame arena
+    VoronoiCore::Force* forces = frameArena.allocate<VoronoiCore::Force>(points.size());
+    if (!forces) {
+        return;
+    }
+
+    VoronoiCore::applyRepulsiveForce(points.data(), points.size(), pinnedMask, screenWidth, screenHeight, forces);
+}
@@ -1,16 +1,48 @@
 #include <M5Unified.h>
+#include <esp_timer.h>
+#include <esp_random.h>
+#include "VoronoiModel.h"
 #include "VoronoiDiagram.h"
 #include "TouchHandler.h"
 #include "TaskManager.h"
 #include "SoundManager.h"
+#include "InputTrace.h"
+#include "RenderSelfTest.h"
+#include "BootProfiler.h"
+#include "HeapMonitor.h"
+#include "LabelStream.h"
+#include "M5TouchInputSource.h"
+#include "M5SpeakerAudioSink.h"
+#include "SyntheticInputSource.h"
 
 // Off-screen buffer
 static M5Canvas screenBuffer;
 
-// Global sound manager
-static SoundManager soundManager;
+// Global sound manager (mixes into the speaker)
+static M5SpeakerAudioSink speakerSink;
+static SoundManager soundManager(speakerSink);
+
+// Global input trace
+static InputTrace inputTrace(Serial, &esp_timer_get_time);
+
+// Global boot profiler
+static BootProfiler bootProfiler;
+
+// Global heap monitor (build with -DVORONOI_HEAP_DEBUG to count frame allocations)
+static HeapMonitor heapMonitor;
+
+// Global label stream (mirrors drawn frames over serial)
+static LabelStream labelStream(Serial, &esp_timer_get_time);
+
+// Global input source (build with -DVORONOI_SYNTHETIC_INPUT to drive the app from a script)
+//   The synthetic source needs the display size, so it is created in setup().
+#ifndef VORONOI_SYNTHETIC_INPUT
+static M5TouchInputSource touchInputSource;
+#endif
+static InputSource* inputSource = nullptr;
 
 // Global objects
+VoronoiModel* voronoiModel = nullptr;
 VoronoiDiagram* voronoiDiagram = nullptr;
 TouchHandler* touchHandler = nullptr;
 TaskManager* taskManager = nullptr;
@@ -18,9 +50,12 @@ SemaphoreHandle_t drawMutex = nullptr;
 
 // Application setup
 static bool setupApplication() {
+    bootProfiler.mark("setup start");
+
     // Initialize M5Stack
     auto cfg = M5.config();
     M5.begin(cfg);
+    bootProfiler.mark("m5 begin");
 
     // Display settings (landscape orientation)
     M5.Display.setRotation(1);
@@ -33,10 +68,12 @@ static bool setupApplication() {
     // Create sprite
     screenBuffer.setColorDepth(8);  // Set to 8-bit color depth
     screenBuffer.createSprite(width, height);
+    bootProfiler.mark("sprite created");
 
-    // Initialize sound manager and play startup sound
+    // Initialize sound manager and queue startup sound (played by the audio task)
     soundManager.initialize();
     soundManager.playStartupSequence();
+    bootProfiler.mark("sound started");
     
     return true;
 }
@@ -59,21 +96,144 @@ void setup() {
     
     configASSERT(drawMutex);
 
-    // Create Voronoi diagram
-    voronoiDiagram = new VoronoiDiagram(screenBuffer, drawMutex);
+    // Create Voronoi diagram (buffers are allocated by allocateBuffers() on the draw task, right after the first frame)
+    voronoiModel = new VoronoiModel(M5.Display.width(), M5.Display.height(), &esp_random);
+    voronoiModel->setInputTrace(&inputTrace);
+    voronoiDiagram = new VoronoiDiagram(*voronoiModel, screenBuffer, drawMutex);
+    voronoiDiagram->setLabelStream(&labelStream);
+
+    // Create input source
+#ifdef VORONOI_SYNTHETIC_INPUT
+    inputSource = new SyntheticInputSource(M5.Display.width(), M5.Display.height(), &esp_timer_get_time);
+#else
+    inputSource = &touchInputSource;
+#endif
 
     // Create touch handler
-    touchHandler = new TouchHandler(*voronoiDiagram, soundManager);
+    touchHandler = new TouchHandler(*voronoiModel, soundManager, inputTrace, *inputSource);
 
     // Create task manager
-    taskManager = new TaskManager(*voronoiDiagram, *touchHandler);
+    taskManager = new TaskManager(*voronoiDiagram, *touchHandler, *inputSource, bootProfiler, heapMonitor);
 
     // Initialize tasks
     taskManager->initializeTasks();
+    bootProfiler.mark("tasks started");
+}
+
+// Wait until the draw task has stopped the trace session
+static void waitForTraceIdle() {
+    while (inputTrace.getMode() != InputTrace::Mode::IDLE) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+// Wait until the draw task has stopped the label stream
+static void waitForStreamIdle() {
+    while (labelStream.isStreaming()) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+// Handle a serial command
+//   R: start recording a trace
+//   S: stop the session and dump the trace in binary
+//   P: replay the trace
+//   L: load a binary trace from serial
+//   T: run the render self-test against the stored timing baselines
+//   U: run the render self-test and record new timing baselines
+//   I: print input sampling and touch event batch statistics
+//   M: toggle between event-driven input sampling and 1 ms polling
+//   A: print audio statistics
+//   H: print heap low-water marks and the frame allocation check
+//   V: start or stop streaming run-length compressed label maps
+//   While the label stream runs, only V is accepted, so that no reply lands inside a packet.
+static void handleSerialCommand(int command) {
+    if (labelStream.isStreaming() && command != 'V') {
+        return;
+    }
+
+    switch (command) {
+        case 'R':
+            inputTrace.initialize();
+            inputTrace.requestRecording();
+            Serial.println("Trace recording requested");
+            break;
+        case 'S':
+            inputTrace.requestStop();
+            waitForTraceIdle();
+            inputTrace.writeTo(Serial);
+            Serial.flush();
+            break;
+        case 'P':
+            inputTrace.requestReplay();
+            Serial.println("Trace replay requested");
+            break;
+        case 'L':
+            inputTrace.requestStop();
+            waitForTraceIdle();
+            inputTrace.initialize();
+            if (inputTrace.readFrom(Serial)) {
+                Serial.printf("Trace loaded: %u records\n", inputTrace.getRecordCount());
+            }
+            break;
+        case 'T':
+        case 'U': {
+            if (voronoiDiagram == nullptr) {
+                break;
+            }
+            RenderSelfTest selfTest(*voronoiDiagram);
+            selfTest.run(Serial, command == 'U');
+            break;
+        }
+        case 'A':
+            soundManager.printStatistics(Serial);
+            break;
+        case 'H':
+            heapMonitor.report(Serial);
+            if (voronoiDiagram != nullptr) {
+                const FrameArena& arena = voronoiDiagram->getFrameArena();
+                Serial.printf("Frame arena: %u of %u bytes used at most, %u overflows\n",
+                              (unsigned)arena.getHighWaterMark(), (unsigned)arena.getCapacity(),
+                              arena.getOverflowCount());
+            }
+            break;
+        case 'V':
+            if (labelStream.isStreaming()) {
+                labelStream.requestStop();
+                waitForStreamIdle();
+                labelStream.printStatistics(Serial);
+            } else if (voronoiDiagram != nullptr
+                       && labelStream.initialize(voronoiDiagram->getWidth(), voronoiDiagram->getHeight())) {
+                Serial.println("Label stream requested");
+                Serial.flush();
+                labelStream.requestStart();
+            }
+            break;
+        case 'I':
+            if (taskManager != nullptr) {
+                taskManager->printStatistics(Serial);
+            }
+            if (touchHandler != nullptr) {
+                touchHandler->printStatistics(Serial);
+            }
+            break;
+        case 'M':
+            if (taskManager != nullptr) {
+                taskManager->setPollingMode(!taskManager->getPollingMode());
+                Serial.println(taskManager->getPollingMode() ? "Input sampling: 1 ms polling" : "Input sampling: event-driven");
+            }
+            break;
+        default:
+            break;
+    }
 }
 
 // Arduino loop function
 void loop() {
-  // Main loop does nothing (all processing is done in separate tasks)
-  vTaskDelay(1000 / portTICK_PERIOD_MS);
+  // Handle serial commands (all drawing is done in separate tasks)
+  while (Serial.available() > 0) {
+    handleSerialCommand(Serial.read());
+  }
+
+  vTaskDelay(100 / portTICK_PERIOD_MS);
 }
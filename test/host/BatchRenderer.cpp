@@ -0,0 +1,191 @@
+#include "BatchRenderer.h"
+#include <exception>
+
+// Constructor
+BatchRenderer::BatchRenderer() {
+}
+
+// Destructor
+BatchRenderer::~BatchRenderer() {
+    stopWorkers();
+}
+
+// Start worker threads and their scratch memory
+bool BatchRenderer::initialize(std::size_t workerCount) {
+    if (!workers.empty()) {
+        return workers.size() == workerCount;
+    }
+
+    if (workerCount == 0) {
+        return false;
+    }
+
+    try {
+        // Scratch memory first, so that the vector is never resized while threads run
+        workers.resize(workerCount);
+        for (Worker& worker : workers) {
+            worker.rowDistances.resize(MAX_SEED_COUNT);
+            worker.diagramCount = 0;
+        }
+
+        for (std::size_t i = 0; i < workerCount; ++i) {
+            workers[i].thread = std::thread(&BatchRenderer::workerLoop, this, i);
+        }
+    } catch (const std::exception&) {
+        // Out of memory or threads: undo the workers started so far
+        stopWorkers();
+        return false;
+    }
+
+    return true;
+}
+
+// Stop and join all workers and free their scratch memory
+void BatchRenderer::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+    batchStarted.notify_all();
+
+    for (Worker& worker : workers) {
+        if (worker.thread.joinable()) {
+            worker.thread.join();
+        }
+    }
+
+    workers.clear();
+    isStopping = false;
+}
+
+// Render a batch on the first workerCount workers
+bool BatchRenderer::render(const SeedBatch& batch, const OutputBuffers& output, std::size_t workerCount) {
+    if (workerCount == 0 || workerCount > workers.size()) {
+        return false;
+    }
+
+    if (!batch.seedOffsets || !batch.x || !batch.y || (!output.labels && !output.pixels)
+        || (output.pixels && !batch.color) || output.width <= 0 || output.height <= 0) {
+        return false;
+    }
+
+    // Labels are 8-bit
+    for (std::size_t i = 0; i < batch.diagramCount; ++i) {
+        if (batch.seedOffsets[i + 1] - batch.seedOffsets[i] > MAX_SEED_COUNT) {
+            return false;
+        }
+    }
+
+    // Wake up the workers and wait until each of them has run out of diagrams
+    std::unique_lock<std::mutex> lock(mutex);
+    currentBatch = &batch;
+    currentOutput = &output;
+    nextDiagram.store(0);
+    for (Worker& worker : workers) {
+        worker.diagramCount = 0;
+    }
+    activeWorkerCount = workerCount;
+    pendingWorkerCount = workerCount;
+    ++batchGeneration;
+    batchStarted.notify_all();
+
+    while (pendingWorkerCount > 0) {
+        batchFinished.wait(lock);
+    }
+
+    currentBatch = nullptr;
+    currentOutput = nullptr;
+    return true;
+}
+
+// Get number of diagrams a worker rendered in the last batch
+uint32_t BatchRenderer::getWorkerDiagramCount(std::size_t index) const {
+    return (index < workers.size()) ? workers[index].diagramCount : 0U;
+}
+
+// Render one diagram of the current batch
+void BatchRenderer::renderDiagram(std::size_t index, Worker& worker) const {
+    const SeedBatch& batch = *currentBatch;
+    const OutputBuffers& output = *currentOutput;
+    const uint32_t first = batch.seedOffsets[index];
+    const std::size_t seedCount = batch.seedOffsets[index + 1] - first;
+    const int16_t* seedX = batch.x + first;
+    const int16_t* seedY = batch.y + first;
+    const std::size_t pixelOffset = index * static_cast<std::size_t>(output.width) * output.height;
+    uint8_t* labels = output.labels ? output.labels + pixelOffset : nullptr;
+    uint16_t* pixels = output.pixels ? output.pixels + pixelOffset : nullptr;
+    int64_t* rowDistances = worker.rowDistances.data();
+
+    // Seeds may lie anywhere in int16_t range, so squared distances are 64-bit
+    for (int y = 0; y < output.height; ++y) {
+        // Vertical distances are shared by the whole row
+        for (std::size_t k = 0; k < seedCount; ++k) {
+            const int64_t dy = y - seedY[k];
+            rowDistances[k] = dy * dy;
+        }
+
+        for (int x = 0; x < output.width; ++x) {
+            // Nearest seed (the lowest index wins ties, as in VoronoiCore)
+            int64_t nearestDistSquared = INT64_MAX;
+            uint8_t label = NO_SEED;
+
+            for (std::size_t k = 0; k < seedCount; ++k) {
+                const int64_t dx = x - seedX[k];
+                const int64_t distSquared = dx * dx + rowDistances[k];
+
+                if (distSquared < nearestDistSquared) {
+                    nearestDistSquared = distSquared;
+                    label = static_cast<uint8_t>(k);
+                }
+            }
+
+            if (labels) {
+                *labels++ = label;
+            }
+            if (pixels) {
+                *pixels++ = (label != NO_SEED) ? batch.color[first + label] : 0;
+            }
+        }
+    }
+}
+
+// Worker thread function
+void BatchRenderer::workerLoop(std::size_t index) {
+    Worker& worker = workers[index];
+    uint32_t seenGeneration = 0;
+
+    for (;;) {
+        // Sleep until a batch for this worker is submitted
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!isStopping && (batchGeneration == seenGeneration || index >= activeWorkerCount)) {
+                // Skip batches that use fewer workers
+                seenGeneration = (index >= activeWorkerCount) ? batchGeneration : seenGeneration;
+                batchStarted.wait(lock);
+            }
+
+            if (isStopping) {
+                return;
+            }
+            seenGeneration = batchGeneration;
+        }
+
+        // Take diagrams until the batch is done
+        const std::size_t diagramCount = currentBatch->diagramCount;
+        for (;;) {
+            const std::size_t diagram = nextDiagram.fetch_add(1);
+            if (diagram >= diagramCount) {
+                break;
+            }
+
+            renderDiagram(diagram, worker);
+            ++worker.diagramCount;
+        }
+
+        // The last worker to finish wakes the caller
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pendingWorkerCount == 0) {
+            batchFinished.notify_one();
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Class for rendering many small Voronoi diagrams (thumbnails and label maps) in bulk
+//   Seed sets are passed in structure-of-arrays layout and rendered into
+//   caller-provided buffers by a pool of persistent worker threads. Workers
+//   pull diagrams from a shared counter and reuse their own scratch memory, so
+//   rendering a batch allocates nothing. Host-only (std::thread and
+//   exceptions), so it lives next to the host tests, outside the firmware.
+class BatchRenderer {
+public:
+    // Seed sets in structure-of-arrays layout
+    //   Seeds of diagram i are [seedOffsets[i], seedOffsets[i + 1]) in x, y and color.
+    struct SeedBatch {
+        std::size_t diagramCount;
+        const uint32_t* seedOffsets;    // diagramCount + 1 entries
+        const int16_t* x;
+        const int16_t* y;
+        const uint16_t* color;          // RGB565 (optional, required for pixels)
+    };
+
+    // Caller-provided output buffers (width * height entries per diagram, back to back)
+    struct OutputBuffers {
+        int width;
+        int height;
+        uint8_t* labels;                // nearest seed index per pixel (optional)
+        uint16_t* pixels;               // RGB565 color per pixel (optional)
+    };
+
+    // Label of pixels without a seed
+    static constexpr uint8_t NO_SEED = 0xFFU;
+
+    // Maximum number of seeds per diagram (labels are 8-bit)
+    static constexpr std::size_t MAX_SEED_COUNT = 255U;
+
+    // Constructor
+    BatchRenderer();
+
+    // Destructor (stops and joins the workers)
+    ~BatchRenderer();
+
+    // Start worker threads and their scratch memory
+    //   On failure every worker started so far is stopped again and false is returned.
+    bool initialize(std::size_t workerCount);
+
+    // Get number of started workers
+    std::size_t getWorkerCount() const { return workers.size(); }
+
+    // Render a batch on the first workerCount workers (blocks until done, not reentrant)
+    bool render(const SeedBatch& batch, const OutputBuffers& output, std::size_t workerCount);
+
+    // Get number of diagrams a worker rendered in the last batch
+    uint32_t getWorkerDiagramCount(std::size_t index) const;
+
+private:
+    // Worker thread state
+    struct Worker {
+        std::thread thread;
+        std::vector<int64_t> rowDistances;  // squared vertical distance to each seed for the current row
+        uint32_t diagramCount;              // diagrams rendered in the current batch
+    };
+
+    // Render one diagram of the current batch
+    void renderDiagram(std::size_t index, Worker& worker) const;
+
+    // Worker thread function
+    void workerLoop(std::size_t index);
+
+    // Stop and join all workers and free their scratch memory
+    void stopWorkers();
+
+    // Workers (the vector is sized before any thread starts and never resized while they run)
+    std::vector<Worker> workers;
+
+    // Batch hand-off between the caller and the workers
+    std::mutex mutex;
+    std::condition_variable batchStarted;
+    std::condition_variable batchFinished;
+    uint32_t batchGeneration = 0;
+    std::size_t activeWorkerCount = 0;
+    std::size_t pendingWorkerCount = 0;
+    bool isStopping = false;
+
+    // Current batch
+    const SeedBatch* currentBatch = nullptr;
+    const OutputBuffers* currentOutput = nullptr;
+    std::atomic<std::size_t> nextDiagram{0};
+};
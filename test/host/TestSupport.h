@@ -0,0 +1,67 @@
+#pragma once
+
+// Helpers shared by the host tests
+#include <Stream.h>
+#include <climits>
+#include <cstdio>
+
+// Pass/fail record of a host test
+//   Every test prints its own results, then one "<name> PASS" or "<name> FAIL" line.
+class TestReport {
+public:
+    // Print a named check and record its result
+    void check(bool condition, const char* name) {
+        std::printf("%-44s %s\n", name, condition ? "ok" : "FAIL");
+        require(condition);
+    }
+
+    // Record a result that the test has already printed
+    void require(bool condition) { passed = passed && condition; }
+
+    // Whether every check so far passed
+    bool isPassed() const { return passed; }
+
+    // Print the final line and return the process exit code
+    int finish(const char* name) const {
+        std::printf("%s %s\n", name, passed ? "PASS" : "FAIL");
+        return passed ? 0 : 1;
+    }
+
+private:
+    bool passed = true;
+};
+
+// Stream on a stdio file (firmware classes that write to Print or read from Stream)
+class FileStream : public Stream {
+public:
+    // Constructor (the file stays owned by the caller)
+    explicit FileStream(FILE* f) : file(f) {}
+
+    size_t write(uint8_t value) override {
+        return (file && std::fputc(value, file) != EOF) ? 1U : 0U;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+        return file ? std::fwrite(buffer, 1, size, file) : 0U;
+    }
+
+    // Files never block
+    int availableForWrite() override { return INT_MAX; }
+
+    int available() override {
+        if (!file) {
+            return 0;
+        }
+        const int value = std::fgetc(file);
+        if (value == EOF) {
+            return 0;
+        }
+        std::ungetc(value, file);
+        return 1;
+    }
+
+    int read() override { return file ? std::fgetc(file) : -1; }
+
+private:
+    FILE* file;
+};
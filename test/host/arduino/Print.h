@@ -0,0 +1,54 @@
+#pragma once
+
+// Minimal Arduino Print for host builds
+//   Only the subset used by the portable firmware classes. Like the Arduino
+//   core, availableForWrite() reports 0 unless a subclass overrides it.
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+class Print {
+public:
+    // Destructor
+    virtual ~Print() {}
+
+    // Write a byte (returns number of bytes written)
+    virtual size_t write(uint8_t value) = 0;
+
+    // Write bytes (returns number of bytes written)
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t written = 0;
+        while (written < size && write(buffer[written]) == 1) {
+            ++written;
+        }
+        return written;
+    }
+
+    // Get number of bytes that can be written without blocking
+    virtual int availableForWrite() { return 0; }
+
+    // Wait until everything has been written
+    virtual void flush() {}
+
+    // Print text
+    size_t print(const char* text) { return write(reinterpret_cast<const uint8_t*>(text), strlen(text)); }
+    size_t println(const char* text) { return print(text) + print("\r\n"); }
+    size_t println() { return print("\r\n"); }
+
+    // Print formatted text
+    __attribute__((format(printf, 2, 3))) size_t printf(const char* format, ...) {
+        char buffer[256];
+        va_list args;
+        va_start(args, format);
+        const int length = vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+
+        if (length <= 0) {
+            return 0;
+        }
+        const size_t size = (static_cast<size_t>(length) < sizeof(buffer)) ? length : sizeof(buffer) - 1;
+        return write(reinterpret_cast<const uint8_t*>(buffer), size);
+    }
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+// Minimal Arduino Stream for host builds (reads never wait for data)
+#include "Print.h"
+
+class Stream : public Print {
+public:
+    // Get number of bytes that can be read
+    virtual int available() = 0;
+
+    // Read a byte (-1 if none is available)
+    virtual int read() = 0;
+
+    // Read bytes (returns number of bytes read)
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        size_t count = 0;
+        while (count < length) {
+            const int value = read();
+            if (value < 0) {
+                break;
+            }
+            buffer[count++] = static_cast<uint8_t>(value);
+        }
+        return count;
+    }
+
+    size_t readBytes(char* buffer, size_t length) {
+        return readBytes(reinterpret_cast<uint8_t*>(buffer), length);
+    }
+};
@@ -0,0 +1,143 @@
+// Mix the firmware's sound effects into a PCM file and check the waveform
+//   Same tones as SoundManager: touch (659.26 Hz, 50 ms) and the startup
+//   sequence (three tones 150 ms apart).
+#include "AudioMixer.h"
+#include "FileAudioSink.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+const float TOUCH_FREQUENCY = 659.26F;
+const uint32_t TOUCH_DURATION_MS = 50U;
+const uint32_t STARTUP_DELAY_MS = 150U;
+
+// Mix until every voice has finished and return the samples read back from the file
+std::vector<int16_t> mixToFile(AudioMixer& mixer, std::size_t& bufferCount) {
+    std::vector<int16_t> samples;
+    FILE* file = std::tmpfile();
+    if (file == nullptr) {
+        return samples;
+    }
+
+    FileAudioSink sink(file);
+    sink.begin();
+
+    int16_t buffer[AudioMixer::BUFFER_SAMPLES];
+    bufferCount = 0;
+    while (mixer.mix(buffer)) {
+        sink.waitForRoom();
+        sink.write(buffer, AudioMixer::BUFFER_SAMPLES, AudioMixer::SAMPLE_RATE);
+        ++bufferCount;
+    }
+
+    // Read the little-endian PCM back
+    std::rewind(file);
+    unsigned char bytes[2];
+    while (std::fread(bytes, 1, sizeof(bytes), file) == sizeof(bytes)) {
+        samples.push_back(static_cast<int16_t>(bytes[0] | (bytes[1] << 8)));
+    }
+    std::fclose(file);
+
+    return samples;
+}
+
+// Index one past the last non-zero sample
+std::size_t findEnd(const std::vector<int16_t>& samples) {
+    std::size_t end = samples.size();
+    while (end > 0 && samples[end - 1] == 0) {
+        --end;
+    }
+    return end;
+}
+
+}  // namespace
+
+int main() {
+    const uint32_t toneSamples = TOUCH_DURATION_MS * AudioMixer::SAMPLE_RATE / 1000U;
+    TestReport report;
+
+    // Touch feedback tone
+    {
+        AudioMixer mixer;
+        mixer.startTone(TOUCH_FREQUENCY, TOUCH_DURATION_MS, 0U);
+
+        std::size_t bufferCount = 0;
+        const std::vector<int16_t> samples = mixToFile(mixer, bufferCount);
+
+        int peak = 0;
+        int risingCrossings = 0;
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            peak = std::max(peak, std::abs(static_cast<int>(samples[i])));
+            if (i > 0 && samples[i - 1] < 0 && samples[i] >= 0) {
+                ++risingCrossings;
+            }
+        }
+        const int expectedCycles = static_cast<int>(TOUCH_FREQUENCY * TOUCH_DURATION_MS / 1000.0F);
+
+        report.check(bufferCount == (toneSamples + AudioMixer::BUFFER_SAMPLES - 1) / AudioMixer::BUFFER_SAMPLES,
+              "touch: buffers until the voice ends");
+        report.check(samples.size() == bufferCount * AudioMixer::BUFFER_SAMPLES, "touch: every buffer reached the file");
+        report.check(findEnd(samples) <= toneSamples && findEnd(samples) > toneSamples - 16U, "touch: duration");
+        report.check(samples[0] == 0 && std::abs(samples[8]) < AudioMixer::WAVETABLE_AMPLITUDE / 4, "touch: attack ramp");
+        report.check(peak > AudioMixer::WAVETABLE_AMPLITUDE * 9 / 10 && peak <= AudioMixer::WAVETABLE_AMPLITUDE,
+              "touch: peak amplitude");
+        report.check(std::abs(risingCrossings - expectedCycles) <= 1, "touch: frequency");
+        report.check(std::abs(samples[toneSamples - 2]) < AudioMixer::WAVETABLE_AMPLITUDE / 64, "touch: release ramp");
+    }
+
+    // Startup sequence
+    {
+        AudioMixer mixer;
+        for (uint32_t i = 0; i < 3U; ++i) {
+            mixer.startTone(TOUCH_FREQUENCY, TOUCH_DURATION_MS, STARTUP_DELAY_MS * i);
+        }
+
+        std::size_t bufferCount = 0;
+        const std::vector<int16_t> samples = mixToFile(mixer, bufferCount);
+        const std::size_t delaySamples = STARTUP_DELAY_MS * AudioMixer::SAMPLE_RATE / 1000U;
+
+        // Every gap between the tones is silent and every tone sounds
+        bool isGapSilent = true;
+        bool isToneAudible = true;
+        for (std::size_t tone = 0; tone < 3U; ++tone) {
+            int peak = 0;
+            for (std::size_t i = tone * delaySamples; i < tone * delaySamples + toneSamples && i < samples.size(); ++i) {
+                peak = std::max(peak, std::abs(static_cast<int>(samples[i])));
+            }
+            isToneAudible = isToneAudible && (peak > AudioMixer::WAVETABLE_AMPLITUDE / 2);
+
+            for (std::size_t i = tone * delaySamples + toneSamples; i < (tone + 1U) * delaySamples && i < samples.size(); ++i) {
+                isGapSilent = isGapSilent && (samples[i] == 0);
+            }
+        }
+
+        report.check(isToneAudible, "startup: three tones");
+        report.check(isGapSilent, "startup: silence between tones");
+        report.check(findEnd(samples) <= 2U * delaySamples + toneSamples, "startup: ends after the third tone");
+    }
+
+    // Voice stealing
+    {
+        AudioMixer mixer;
+        for (std::size_t i = 0; i <= AudioMixer::MAX_VOICE_COUNT; ++i) {
+            mixer.startTone(TOUCH_FREQUENCY * (i + 1U), TOUCH_DURATION_MS + i, 0U);
+        }
+        report.check(mixer.getActiveVoiceCount() == AudioMixer::MAX_VOICE_COUNT, "stealing: voice count is bounded");
+
+        std::size_t bufferCount = 0;
+        const std::vector<int16_t> samples = mixToFile(mixer, bufferCount);
+        int peak = 0;
+        for (int16_t sample : samples) {
+            peak = std::max(peak, std::abs(static_cast<int>(sample)));
+        }
+        report.check(peak <= AudioMixer::WAVETABLE_AMPLITUDE * static_cast<int>(AudioMixer::MAX_VOICE_COUNT),
+              "stealing: mix stays below full scale");
+        report.check(mixer.getActiveVoiceCount() == 0U, "stealing: every voice ends");
+    }
+
+    return report.finish("AUDIO");
+}
@@ -0,0 +1,148 @@
+// Benchmark batch rendering of thumbnail diagrams against the number of worker threads
+//   Every thread count from 1 to hardware_concurrency() must produce the same
+//   label maps and pixels, and the label maps must match VoronoiCore's exact
+//   nearest-point search.
+#include "BatchRenderer.h"
+#include "RenderCheck.h"
+#include "TestSupport.h"
+#include "VoronoiCore.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const std::size_t DIAGRAM_COUNT = 256U;
+const int WIDTH = 80;
+const int HEIGHT = 60;
+const std::size_t SEED_COUNT = 16U;
+const int RUN_COUNT = 3;
+
+// FNV-1a hash of a buffer
+uint32_t hashBytes(const void* data, std::size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint32_t hash = 2166136261U;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 16777619U;
+    }
+    return hash;
+}
+
+}  // namespace
+
+int main() {
+    const std::size_t seedTotal = DIAGRAM_COUNT * SEED_COUNT;
+    const std::size_t pixelCount = static_cast<std::size_t>(WIDTH) * HEIGHT;
+    const std::size_t pixelTotal = DIAGRAM_COUNT * pixelCount;
+    const std::size_t maxThreadCount = std::max(1U, std::thread::hardware_concurrency());
+
+    // Seed sets from a linear congruential generator
+    std::vector<uint32_t> offsets(DIAGRAM_COUNT + 1);
+    std::vector<int16_t> xs(seedTotal);
+    std::vector<int16_t> ys(seedTotal);
+    std::vector<uint16_t> colors(seedTotal);
+    std::vector<uint8_t> labels(pixelTotal);
+    std::vector<uint16_t> pixels(pixelTotal);
+
+    uint32_t state = 0x5EED5EEDU;
+    for (std::size_t i = 0; i < seedTotal; ++i) {
+        xs[i] = RenderCheck::nextRandom(state) % WIDTH;
+        ys[i] = RenderCheck::nextRandom(state) % HEIGHT;
+        colors[i] = RenderCheck::nextRandom(state) >> 8;
+    }
+    for (std::size_t i = 0; i <= DIAGRAM_COUNT; ++i) {
+        offsets[i] = i * SEED_COUNT;
+    }
+
+    const BatchRenderer::SeedBatch batch = {DIAGRAM_COUNT, offsets.data(), xs.data(), ys.data(), colors.data()};
+    const BatchRenderer::OutputBuffers output = {WIDTH, HEIGHT, labels.data(), pixels.data()};
+
+    BatchRenderer renderer;
+    bool passed = renderer.initialize(maxThreadCount);
+    if (!passed) {
+        std::printf("Failed to start %u worker threads\n", (unsigned)maxThreadCount);
+    }
+
+    std::printf("Batch: %u diagrams of %dx%d with %u seeds\n", (unsigned)DIAGRAM_COUNT, WIDTH, HEIGHT,
+                (unsigned)SEED_COUNT);
+
+    double singleThreadRate = 0.0;
+    uint32_t referenceHash = 0;
+
+    for (std::size_t threadCount = 1; threadCount <= maxThreadCount && passed; ++threadCount) {
+        // Fastest of several runs
+        double elapsedSeconds = 1.0e9;
+        for (int run = 0; run < RUN_COUNT && passed; ++run) {
+            std::memset(labels.data(), 0, pixelTotal);
+            std::memset(pixels.data(), 0, pixelTotal * sizeof(uint16_t));
+
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            passed = renderer.render(batch, output, threadCount);
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            elapsedSeconds = std::min(elapsedSeconds, elapsed.count());
+        }
+
+        // Every thread count must produce the same label maps and pixels
+        const uint32_t hash = hashBytes(labels.data(), pixelTotal)
+            ^ hashBytes(pixels.data(), pixelTotal * sizeof(uint16_t));
+        if (threadCount == 1) {
+            referenceHash = hash;
+        }
+        passed = passed && (hash == referenceHash);
+
+        const double rate = (elapsedSeconds > 0.0) ? DIAGRAM_COUNT / elapsedSeconds : 0.0;
+        if (threadCount == 1) {
+            singleThreadRate = rate;
+        }
+
+        std::printf("  %2u thread(s): %9.1f diagrams/s  speedup %.2fx  split", (unsigned)threadCount, rate,
+                    (singleThreadRate > 0.0) ? rate / singleThreadRate : 0.0);
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            std::printf(" %u", renderer.getWorkerDiagramCount(i));
+        }
+        std::printf("  hash %08x\n", hash);
+    }
+
+    // Labels of the last run against the exact search (colors follow the labels)
+    std::vector<VoronoiCore::Point> points(SEED_COUNT);
+    uint32_t mismatchCount = 0;
+    for (std::size_t diagram = 0; diagram < DIAGRAM_COUNT && passed; ++diagram) {
+        for (std::size_t k = 0; k < SEED_COUNT; ++k) {
+            const std::size_t seed = offsets[diagram] + k;
+            points[k] = {xs[seed], ys[seed], colors[seed]};
+        }
+
+        const std::size_t base = diagram * pixelCount;
+        for (int y = 0; y < HEIGHT; ++y) {
+            for (int x = 0; x < WIDTH; ++x) {
+                const int expected = VoronoiCore::getNearestPointIndex(points.data(), SEED_COUNT, x, y);
+                const std::size_t idx = base + y * WIDTH + x;
+                if (labels[idx] != expected || pixels[idx] != points[expected].color) {
+                    ++mismatchCount;
+                }
+            }
+        }
+    }
+    std::printf("pixels differing from the exact search: %u\n", mismatchCount);
+    passed = passed && (mismatchCount == 0U);
+
+    // Seeds at the ends of the int16_t range must not overflow the squared distances
+    const uint32_t farOffsets[2] = {0U, 3U};
+    const int16_t farX[3] = {-32768, 32767, WIDTH / 2};
+    const int16_t farY[3] = {-32768, 32767, HEIGHT / 2};
+    const BatchRenderer::SeedBatch farBatch = {1U, farOffsets, farX, farY, nullptr};
+    const BatchRenderer::OutputBuffers farOutput = {WIDTH, HEIGHT, labels.data(), nullptr};
+    bool isFarSeedIgnored = renderer.render(farBatch, farOutput, 1U);
+    for (std::size_t i = 0; i < pixelCount && isFarSeedIgnored; ++i) {
+        isFarSeedIgnored = (labels[i] == 2U);
+    }
+    std::printf("seeds at the int16_t limits: %s\n", isFarSeedIgnored ? "ok" : "FAIL");
+    passed = passed && isFarSeedIgnored;
+
+    TestReport report;
+    report.require(passed);
+    return report.finish("BATCH");
+}
@@ -0,0 +1,139 @@
+// Run the frame step of VoronoiDiagram::draw() and fail on any heap allocation after warmup
+//   VoronoiModel::step() is the portable part of every drawn frame: frame arena
+//   reset, repulsive force, relabel decision and label map update. Allocations
+//   are counted through the linker (--wrap=malloc and friends); operator new is
+//   routed through malloc.
+#include "RenderCheck.h"
+#include "TestSupport.h"
+#include "VoronoiModel.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace {
+
+typedef VoronoiCore::Point Point;
+
+const int WIDTH = 320;
+const int HEIGHT = 240;
+const int WARMUP_FRAMES = 10;
+const int CHECKED_FRAMES = 200;
+
+// Allocation counter (enabled after warmup)
+std::atomic<bool> isCountingEnabled{false};
+std::atomic<uint32_t> allocationCount{0};
+
+void recordAllocation() {
+    if (isCountingEnabled.load(std::memory_order_relaxed)) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace
+
+// C allocation hooks (linked with --wrap)
+extern "C" {
+void* __real_malloc(std::size_t size);
+void* __real_calloc(std::size_t count, std::size_t size);
+void* __real_realloc(void* ptr, std::size_t size);
+void __real_free(void* ptr);
+
+void* __wrap_malloc(std::size_t size) {
+    recordAllocation();
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(std::size_t count, std::size_t size) {
+    recordAllocation();
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, std::size_t size) {
+    recordAllocation();
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void* ptr) {
+    __real_free(ptr);
+}
+}
+
+// C++ allocations go through the wrapped malloc
+void* operator new(std::size_t size) {
+    void* ptr = malloc(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    __real_free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    __real_free(ptr);
+}
+
+// Point colors (the step does not depend on them)
+uint32_t getZero() {
+    return 0;
+}
+
+int main() {
+    // Buffers are allocated up front, as on the device
+    VoronoiModel model(WIDTH, HEIGHT, &getZero);
+    bool isAllocated = model.allocateBuffers();
+
+    std::vector<Point> points;
+    RenderCheck::generatePoints(RenderCheck::SEED_SETS[RenderCheck::SEED_SET_COUNT - 1], WIDTH, HEIGHT, points);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        model.addPoint(points[i].x, points[i].y);
+    }
+
+    // The counter itself must see both kinds of allocation (volatile keeps the pairs from being elided)
+    isCountingEnabled.store(true);
+    void* volatile cProbe = malloc(16);
+    free(cProbe);
+    int* volatile cppProbe = new int(0);
+    delete cppProbe;
+    const bool isCounterWorking = (allocationCount.exchange(0) == 2U);
+    isCountingEnabled.store(false);
+
+    uint32_t incrementalCount = 0;
+    for (int frame = 0; frame < WARMUP_FRAMES + CHECKED_FRAMES; ++frame) {
+        if (frame == WARMUP_FRAMES) {
+            allocationCount.store(0);
+            isCountingEnabled.store(true);
+        }
+
+        // Drag the first point around while the others repel each other
+        model.movePoint(0, (frame * 7) % WIDTH, (frame * 3) % HEIGHT);
+        if (model.step(VoronoiCore::NoPaint()) == VoronoiModel::StepResult::INCREMENTAL) {
+            ++incrementalCount;
+        }
+        isAllocated = isAllocated && (model.getLabelMap() != nullptr);
+    }
+
+    isCountingEnabled.store(false);
+    const uint32_t count = allocationCount.load();
+
+    const FrameArena& frameArena = model.getFrameArena();
+    std::printf("label map allocated and valid every frame: %s\n", isAllocated ? "yes" : "NO");
+    std::printf("allocation counter sees malloc and new: %s\n", isCounterWorking ? "yes" : "NO");
+    std::printf("incremental steps: %u of %d\n", incrementalCount, WARMUP_FRAMES + CHECKED_FRAMES);
+    std::printf("frame allocations after %d warmup frames: %u in %d frames\n", WARMUP_FRAMES, count, CHECKED_FRAMES);
+    std::printf("frame arena: %u of %u bytes used at most, %u overflows\n",
+                (unsigned)frameArena.getHighWaterMark(), (unsigned)frameArena.getCapacity(),
+                frameArena.getOverflowCount());
+
+    TestReport report;
+    report.require(isAllocated && isCounterWorking && count == 0U && frameArena.getOverflowCount() == 0U);
+    return report.finish("HEAP CHECK");
+}
@@ -0,0 +1,127 @@
+// Encode keyframes, deltas and empty frames to a file for the decoder round trip
+//   Writes <prefix>.bin (the stream) and <prefix>.expected (the label map size,
+//   then every frame's seeds and label map); test_label_stream.py decodes the stream with
+//   tools/decode_label_stream.py and compares the two.
+#include "LabelStream.h"
+#include "TestSupport.h"
+#include "VoronoiCore.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef VoronoiCore::Point Point;
+
+const int WIDTH = 320;
+const int HEIGHT = 240;
+const uint32_t FRAME_COUNT = 90U;
+
+// Fake clock (advanced by one frame per encode)
+int64_t nowUs = 0;
+
+int64_t readClock() {
+    return nowUs;
+}
+
+// Seeds of a frame (empty frames have none)
+void buildFrame(uint32_t frame, std::vector<Point>& points) {
+    points.clear();
+
+    // Empty screen, three static points, then a drag with more points added
+    if (frame < 2U || (frame >= 76U && frame < 80U)) {
+        return;
+    }
+
+    points.push_back({40, 30, 0xED79});
+    points.push_back({200, 120, 0xB71B});
+    points.push_back({300, 200, 0xFF35});
+
+    if (frame >= 6U && frame < 70U) {
+        points[1].x = 200 - static_cast<int>(frame - 6U) * 2;
+        points[1].y = 120 + static_cast<int>(frame - 6U) % 7;
+    }
+
+    if (frame >= 30U && frame < 76U) {
+        points.push_back({10, 230, 0xC759});
+        points.push_back({160, 10, 0xB5BB});
+    }
+
+    if (frame >= 80U) {
+        points.resize(1);
+    }
+}
+
+// Append a frame to the expected file
+void writeExpected(FILE* file, uint32_t frame, const std::vector<Point>& points, const std::vector<uint8_t>& labels) {
+    const uint8_t seedCount = static_cast<uint8_t>(points.size());
+    std::fwrite(&frame, sizeof(frame), 1, file);
+    std::fwrite(&seedCount, sizeof(seedCount), 1, file);
+    for (const Point& point : points) {
+        const LabelStream::Seed seed = {static_cast<int16_t>(point.x), static_cast<int16_t>(point.y), point.color};
+        std::fwrite(&seed, sizeof(seed), 1, file);
+    }
+    std::fwrite(labels.data(), 1, labels.size(), file);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <output prefix>\n", argv[0]);
+        return 2;
+    }
+
+    const std::string prefix = argv[1];
+    FILE* streamFile = std::fopen((prefix + ".bin").c_str(), "wb");
+    FILE* expectedFile = std::fopen((prefix + ".expected").c_str(), "wb");
+    if (!streamFile || !expectedFile) {
+        std::fprintf(stderr, "Failed to open %s.bin or %s.expected\n", prefix.c_str(), prefix.c_str());
+        return 1;
+    }
+
+    // The expected file starts with the label map size
+    const uint16_t size[2] = {static_cast<uint16_t>(WIDTH), static_cast<uint16_t>(HEIGHT)};
+    std::fwrite(size, sizeof(size), 1, expectedFile);
+
+    FileStream streamOutput(streamFile);
+    FileStream console(stdout);
+    LabelStream stream(streamOutput, &readClock);
+    bool passed = stream.initialize(WIDTH, HEIGHT);
+
+    const std::size_t pixelCount = static_cast<std::size_t>(WIDTH) * HEIGHT;
+    std::vector<uint8_t> labels(pixelCount);
+    std::vector<Point> points;
+
+    stream.requestStart();
+    for (uint32_t frame = 0; frame < FRAME_COUNT && passed; ++frame) {
+        buildFrame(frame, points);
+
+        // Empty frames are encoded without a label map, as by VoronoiDiagram::draw()
+        if (points.empty()) {
+            std::fill(labels.begin(), labels.end(), LabelStream::NO_SEED);
+            stream.encodeFrame(frame, nullptr, nullptr, 0);
+        } else {
+            VoronoiCore::computeBruteForce(points.data(), points.size(), WIDTH, HEIGHT, labels.data(),
+                                           VoronoiCore::NoPaint());
+            stream.encodeFrame(frame, labels.data(), points.data(), points.size());
+        }
+
+        writeExpected(expectedFile, frame, points, labels);
+        nowUs += 10000;
+    }
+
+    // The stream stops at the next frame once the last packet is out
+    stream.requestStop();
+    stream.encodeFrame(FRAME_COUNT, nullptr, nullptr, 0);
+    passed = passed && !stream.isStreaming();
+
+    stream.printStatistics(console);
+    std::fclose(streamFile);
+    std::fclose(expectedFile);
+
+    TestReport report;
+    report.require(passed);
+    return report.finish("ENCODE");
+}
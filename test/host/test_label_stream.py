@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""Decode the stream written by test_label_stream and compare the label maps.
+
+Usage: test_label_stream.py <output prefix of test_label_stream>
+"""
+
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "tools"))
+import decode_label_stream  # noqa: E402
+
+EXPECTED_HEADER = struct.Struct("<HH")
+EXPECTED_FRAME = struct.Struct("<IB")
+EXPECTED_SEED = struct.Struct("<hhH")
+
+all_passed = True
+
+
+def check(condition, name):
+    global all_passed
+    print("%-44s %s" % (name, "ok" if condition else "FAIL"))
+    all_passed = all_passed and condition
+
+
+def read_expected(path):
+    """Return (width, height, [(frame, seeds, labels)])."""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    width, height = EXPECTED_HEADER.unpack_from(data)
+    offset = EXPECTED_HEADER.size
+    frames = []
+    while offset < len(data):
+        frame, seed_count = EXPECTED_FRAME.unpack_from(data, offset)
+        offset += EXPECTED_FRAME.size
+        seeds = [EXPECTED_SEED.unpack_from(data, offset + i * EXPECTED_SEED.size) for i in range(seed_count)]
+        offset += seed_count * EXPECTED_SEED.size
+        labels = data[offset:offset + width * height]
+        offset += width * height
+        frames.append((frame, seeds, labels))
+    return width, height, frames
+
+
+def decode(stream):
+    """Return (decoder, {frame: (width, height, labels, seeds)})."""
+    decoded = {}
+
+    def on_frame(frame, width, height, labels, seeds):
+        decoded[frame] = (width, height, labels, seeds)
+
+    decoder = decode_label_stream.Decoder(on_frame)
+    decoder.feed(stream)
+    return decoder, decoded
+
+
+def matches(expected, decoded, width, height):
+    """Check every decoded frame against the expected seeds and label map."""
+    by_frame = {frame: (seeds, labels) for (frame, seeds, labels) in expected}
+    for frame, (w, h, labels, seeds) in decoded.items():
+        seeds_expected, labels_expected = by_frame[frame]
+        if (w, h) != (width, height) or labels != labels_expected or seeds != seeds_expected:
+            print("frame %u differs" % frame)
+            return False
+    return True
+
+
+def main():
+    prefix = sys.argv[1]
+    width, height, expected = read_expected(prefix + ".expected")
+    with open(prefix + ".bin", "rb") as f:
+        stream = f.read()
+
+    # Clean stream: every change reaches the decoder
+    decoder, decoded = decode(stream)
+    changed = [frame for i, (frame, seeds, labels) in enumerate(expected)
+               if i == 0 or (seeds, labels) != expected[i - 1][1:]]
+    empty = [frame for (frame, seeds, _) in expected if not seeds]
+
+    check(matches(expected, decoded, width, height), "decoded label maps match")
+    check(all(frame in decoded for frame in changed), "every changed frame is decoded")
+    check(any(frame in decoded for frame in empty[1:]), "empty frames after points are decoded")
+    check(decoder.keyframe_count >= 2, "periodic keyframe")
+    check(decoder.dropped_count == 0, "no packet dropped")
+
+    # Corrupted delta: dropped, then decoding resumes at the next keyframe
+    starts = []
+    index = stream.find(decode_label_stream.MAGIC)
+    while index >= 0:
+        starts.append(index)
+        index = stream.find(decode_label_stream.MAGIC, index + 1)
+    corrupted = bytearray(stream)
+    corrupted[starts[3] + decode_label_stream.HEADER.size + 1] ^= 0x5A
+    corrupted_frame = decode_label_stream.HEADER.unpack_from(stream, starts[3])[6]
+    decoder, decoded_corrupted = decode(bytes(corrupted))
+
+    check(decoder.dropped_count >= 1, "corrupted packet is dropped")
+    check(corrupted_frame not in decoded_corrupted, "corrupted frame is not emitted")
+    check(matches(expected, decoded_corrupted, width, height), "emitted label maps still match")
+    check(any(frame > corrupted_frame for frame in decoded_corrupted), "decoding resumes at the next keyframe")
+
+    print("ROUND TRIP PASS" if all_passed else "ROUND TRIP FAIL")
+    return 0 if all_passed else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,121 @@
+// Compare the JFA and incremental label maps against the exact brute-force map
+//   Same screen size, seed sets and limits as the on-device render self-test.
+//   Every path is timed next to brute force; with enough seeds to matter, the
+//   incremental path fails if it is not clearly faster than brute force.
+#include "RenderCheck.h"
+#include "TestSupport.h"
+#include "VoronoiCore.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+typedef VoronoiCore::Point Point;
+
+const int WIDTH = 320;
+const int HEIGHT = 240;
+
+// Number of timed runs per path (the fastest one is reported)
+const int TIMING_RUN_COUNT = 3;
+
+// Required speedup of the incremental path over brute force, checked from this many seeds on
+//   With few seeds a brute-force pixel costs about as much as an incremental one.
+const double MIN_INCREMENTAL_SPEEDUP = 1.5;
+const std::size_t MIN_TIMED_SEED_COUNT = 10U;
+
+// Time a render (fastest of several runs, in microseconds)
+template<typename Prepare, typename Render>
+double timeRender(Prepare prepare, Render render) {
+    double fastest = 1.0e12;
+    for (int run = 0; run < TIMING_RUN_COUNT; ++run) {
+        prepare();
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        render();
+        const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        fastest = std::min(fastest, elapsed.count());
+    }
+    return fastest;
+}
+
+}  // namespace
+
+int main() {
+    const std::size_t pixelCount = static_cast<std::size_t>(WIDTH) * HEIGHT;
+    std::vector<int16_t> reference(pixelCount);
+    std::vector<int16_t> candidate(pixelCount);
+    std::vector<int16_t> updated(pixelCount);
+    std::vector<VoronoiCore::SeedPoint> bufferA(pixelCount);
+    std::vector<VoronoiCore::SeedPoint> bufferB(pixelCount);
+    std::vector<Point> seeds;
+    std::vector<Point> previous;
+    TestReport report;
+
+    std::printf("set      seeds path         time_us  speedup  mismatched  farther  result\n");
+
+    for (std::size_t setIndex = 0; setIndex < RenderCheck::SEED_SET_COUNT; ++setIndex) {
+        const RenderCheck::SeedSet& set = RenderCheck::SEED_SETS[setIndex];
+        RenderCheck::generatePoints(set, WIDTH, HEIGHT, seeds);
+        const bool isTimed = (seeds.size() >= MIN_TIMED_SEED_COUNT);
+
+        // Exact reference
+        const double referenceMicros = timeRender([] {}, [&] {
+            VoronoiCore::computeBruteForce(seeds.data(), seeds.size(), WIDTH, HEIGHT, reference.data(),
+                                           VoronoiCore::NoPaint());
+        });
+        std::printf("%-8s %5u %-11s %8.0f  %6.2fx  %10u  %7u  %s\n", set.name, (unsigned)seeds.size(),
+                    "brute-force", referenceMicros, 1.0, 0U, 0U, "ok");
+
+        // Jump Flooding Algorithm (approximate)
+        const double jfaMicros = timeRender([] {}, [&] {
+            VoronoiCore::executeJFA(seeds.data(), seeds.size(), WIDTH, HEIGHT, bufferA.data(), bufferB.data());
+        });
+        for (std::size_t i = 0; i < pixelCount; ++i) {
+            candidate[i] = bufferA[i].idx;
+        }
+
+        // Incremental update after a drag of the last point (exact, only the update is timed)
+        previous = seeds;
+        RenderCheck::dragLastPoint(previous, WIDTH, HEIGHT);
+        const uint32_t movedMask = VoronoiCore::getMovedPointMask(seeds.data(), previous.data(), seeds.size());
+        const double incrementalMicros = timeRender([&] {
+            VoronoiCore::computeBruteForce(previous.data(), previous.size(), WIDTH, HEIGHT, updated.data(),
+                                           VoronoiCore::NoPaint());
+        }, [&] {
+            VoronoiCore::updateMovedLabels(seeds.data(), seeds.size(), movedMask, WIDTH, HEIGHT, updated.data(),
+                                           VoronoiCore::NoPaint());
+        });
+
+        const struct {
+            const char* name;
+            const std::vector<int16_t>& labels;
+            double micros;
+            double maxErrorRatio;
+            double minSpeedup;
+        } paths[] = {
+            // JFA checks 9 neighbours in each of 9 passes per pixel whatever the seed count,
+            // so up to 16 seeds it is slower than brute force; its speedup is only reported
+            {"jfa", candidate, jfaMicros, RenderCheck::JFA_MAX_ERROR_RATIO, 0.0},
+            {"incremental", updated, incrementalMicros, 0.0, MIN_INCREMENTAL_SPEEDUP}
+        };
+
+        for (const auto& path : paths) {
+            uint32_t mismatched = 0;
+            uint32_t farther = 0;
+            RenderCheck::compareLabels(seeds.data(), seeds.size(), WIDTH, HEIGHT, reference.data(),
+                                       path.labels.data(), mismatched, farther);
+
+            const double speedup = (path.micros > 0.0) ? referenceMicros / path.micros : 0.0;
+            const bool isAccurate = (farther <= path.maxErrorRatio * pixelCount);
+            const bool isFastEnough = !isTimed || speedup >= path.minSpeedup;
+            report.require(isAccurate && isFastEnough);
+
+            std::printf("%-8s %5u %-11s %8.0f  %6.2fx  %10u  %7u  %s\n", set.name, (unsigned)seeds.size(),
+                        path.name, path.micros, speedup, mismatched, farther,
+                        !isAccurate ? "FAIL (accuracy)" : (!isFastEnough ? "FAIL (speed)" : "ok"));
+        }
+    }
+
+    return report.finish("SELF-TEST");
+}
@@ -0,0 +1,247 @@
+// Replay a checked-in input trace through TouchHandler and VoronoiModel
+//   The trace holds the touch events, the random color draws and the hash of
+//   every frame (label map and points). Replaying it on the host runs the same
+//   event handling and frame step as the draw task, so any change to either
+//   shows up as a hash mismatch against the recording.
+//
+//   test_replay <trace>            replay the trace and check every frame hash
+//   test_replay --record <trace>   record the scripted session into the trace
+#include "InputSource.h"
+#include "InputTrace.h"
+#include "RenderCheck.h"
+#include "SoundPlayer.h"
+#include "TestSupport.h"
+#include "TouchHandler.h"
+#include "VoronoiModel.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const int WIDTH = 320;
+const int HEIGHT = 240;
+
+// Frame interval of the draw task
+const int64_t FRAME_INTERVAL_US = 16000;
+
+// Scripted touch stroke (a tap when it does not move)
+struct Stroke {
+    uint32_t startFrame;
+    uint32_t endFrame;      // first frame without the touch
+    uint16_t id;
+    int16_t startX;
+    int16_t startY;
+    int16_t endX;
+    int16_t endY;
+};
+
+// Taps that fill the diagram (and evict the oldest points), drags by one and
+// two fingers, and a drag still held when the recording stops
+const Stroke SCRIPT[] = {
+    {2, 4, 1, 40, 40, 40, 40},
+    {6, 8, 1, 280, 50, 280, 50},
+    {10, 12, 1, 160, 120, 160, 120},
+    {14, 16, 1, 60, 200, 60, 200},
+    {18, 20, 1, 260, 190, 260, 190},
+    {22, 50, 1, 160, 120, 120, 90},
+    {55, 85, 1, 40, 40, 100, 60},
+    {55, 85, 2, 280, 50, 220, 150},
+    {90, 92, 1, 20, 120, 20, 120},
+    {93, 95, 1, 300, 120, 300, 120},
+    {96, 98, 1, 160, 20, 160, 20},
+    {99, 101, 1, 160, 220, 160, 220},
+    {102, 104, 1, 100, 100, 100, 100},
+    {105, 107, 1, 220, 100, 220, 100},
+    {108, 110, 1, 100, 160, 100, 160},
+    {111, 113, 1, 220, 160, 220, 160},
+    {114, 116, 1, 80, 30, 80, 30},
+    {117, 119, 1, 240, 30, 240, 30},
+    {120, 122, 1, 80, 210, 80, 210},
+    {123, 125, 1, 240, 210, 240, 210},
+    {126, 128, 1, 130, 60, 130, 60},
+    {129, 131, 1, 190, 180, 190, 180},
+    {132, 170, 1, 130, 60, 200, 110},
+    {175, 230, 1, 190, 180, 150, 150}
+};
+
+const std::size_t SCRIPT_LENGTH = sizeof(SCRIPT) / sizeof(SCRIPT[0]);
+
+// Frame at which the recording stops (while the last drag is held)
+const uint32_t RECORD_STOP_FRAME = 200U;
+
+// Touch source that plays the script one frame at a time
+class ScriptedInputSource : public InputSource {
+public:
+    void setFrame(uint32_t frame) { currentFrame = frame; }
+
+    void begin(TaskHandle_t) override {}
+
+    bool waitForActivity(uint32_t) override { return true; }
+
+    uint8_t read(TouchPoint* points, uint8_t maxCount) override {
+        uint8_t count = 0;
+        for (std::size_t i = 0; i < SCRIPT_LENGTH && count < maxCount; ++i) {
+            const Stroke& stroke = SCRIPT[i];
+            if (currentFrame < stroke.startFrame || currentFrame >= stroke.endFrame) {
+                continue;
+            }
+
+            // Linear path from the start to the end position
+            const int32_t span = static_cast<int32_t>(stroke.endFrame - stroke.startFrame - 1U);
+            const int32_t step = static_cast<int32_t>(currentFrame - stroke.startFrame);
+            const int32_t x = (span > 0) ? stroke.startX + (stroke.endX - stroke.startX) * step / span : stroke.startX;
+            const int32_t y = (span > 0) ? stroke.startY + (stroke.endY - stroke.startY) * step / span : stroke.startY;
+            points[count++] = {static_cast<int16_t>(x), static_cast<int16_t>(y), stroke.id};
+        }
+        return count;
+    }
+
+    int64_t getLastActivityTimeUs() const override { return 0; }
+
+private:
+    uint32_t currentFrame = 0;
+};
+
+// Sound player that only counts the sounds
+class CountingSoundPlayer : public SoundPlayer {
+public:
+    void playSound(SoundType type) override {
+        if (type == SoundType::TOUCH) {
+            ++touchCount;
+        } else if (type == SoundType::EVICTION) {
+            ++evictionCount;
+        }
+    }
+
+    uint32_t touchCount = 0;
+    uint32_t evictionCount = 0;
+};
+
+// Simulated clock (advanced by one frame interval per frame)
+int64_t simulatedTimeUs = 0;
+
+int64_t getSimulatedTime() {
+    return simulatedTimeUs;
+}
+
+// Color draws (seeded differently for recording and replay, so replayed colors must come from the trace)
+uint32_t randomState = 0;
+
+uint32_t getRandom() {
+    return RenderCheck::nextRandom(randomState);
+}
+
+// Run one frame of the draw task
+void runFrame(TouchHandler& touchHandler, VoronoiModel& model) {
+    touchHandler.processEvents();
+    model.step(VoronoiCore::NoPaint());
+    touchHandler.finishFrame();
+    simulatedTimeUs += FRAME_INTERVAL_US;
+}
+
+// Record the scripted session into a trace file
+int record(const char* path) {
+    FileStream console(stdout);
+    InputTrace inputTrace(console, &getSimulatedTime);
+    VoronoiModel model(WIDTH, HEIGHT, &getRandom);
+    ScriptedInputSource inputSource;
+    CountingSoundPlayer soundPlayer;
+    TouchHandler touchHandler(model, soundPlayer, inputTrace, inputSource);
+
+    randomState = 0x5EED0001U;
+    model.setInputTrace(&inputTrace);
+    if (!model.allocateBuffers() || !inputTrace.initialize()) {
+        return 1;
+    }
+
+    inputTrace.requestRecording();
+    for (uint32_t frame = 0; frame < RECORD_STOP_FRAME; ++frame) {
+        // The touch task samples once per frame
+        inputSource.setFrame(frame);
+        touchHandler.handleInput();
+        runFrame(touchHandler, model);
+    }
+    inputTrace.requestStop();
+    runFrame(touchHandler, model);
+
+    FILE* file = std::fopen(path, "wb");
+    if (!file) {
+        std::printf("Cannot write %s\n", path);
+        return 1;
+    }
+    FileStream output(file);
+    const bool isWritten = inputTrace.writeTo(output);
+    std::fclose(file);
+
+    std::printf("Recorded %u records, %u taps, %u evictions into %s\n", inputTrace.getRecordCount(),
+                soundPlayer.touchCount, soundPlayer.evictionCount, path);
+    return isWritten ? 0 : 1;
+}
+
+// Replay a trace file and check every frame hash
+int replay(const char* path) {
+    FileStream console(stdout);
+    InputTrace inputTrace(console, &getSimulatedTime);
+    VoronoiModel model(WIDTH, HEIGHT, &getRandom);
+    ScriptedInputSource inputSource;
+    CountingSoundPlayer soundPlayer;
+    TouchHandler touchHandler(model, soundPlayer, inputTrace, inputSource);
+    TestReport report;
+
+    randomState = 0xBAD5EEDU;
+    model.setInputTrace(&inputTrace);
+    report.check(model.allocateBuffers() && inputTrace.initialize(), "buffers allocated");
+
+    FILE* file = std::fopen(path, "rb");
+    FileStream input(file);
+    report.check(file != nullptr && inputTrace.readFrom(input), "trace loaded");
+    if (file) {
+        std::fclose(file);
+    }
+    if (!report.isPassed()) {
+        return report.finish("REPLAY");
+    }
+
+    // Run frames until the trace runs out and the session stops
+    inputTrace.requestReplay();
+    touchHandler.processEvents();
+    report.check(inputTrace.getMode() == InputTrace::Mode::REPLAYING, "replay started");
+
+    uint32_t frameCount = 0;
+    while (inputTrace.getMode() == InputTrace::Mode::REPLAYING && frameCount <= RECORD_STOP_FRAME) {
+        model.step(VoronoiCore::NoPaint());
+        touchHandler.finishFrame();
+        simulatedTimeUs += FRAME_INTERVAL_US;
+        touchHandler.processEvents();
+        ++frameCount;
+    }
+
+    std::printf("Replayed %u frames: %u points, %u taps, %u evictions\n", inputTrace.getReplayedFrameCount(),
+                (unsigned)model.getPointCount(), soundPlayer.touchCount, soundPlayer.evictionCount);
+
+    report.check(inputTrace.getMode() == InputTrace::Mode::IDLE, "replay stopped at the end of the trace");
+    report.check(inputTrace.getReplayedFrameCount() == RECORD_STOP_FRAME, "every recorded frame replayed");
+    report.check(inputTrace.getHashMismatchCount() == 0, "frame hashes match the recording");
+    report.check(inputTrace.getRandomDivergenceCount() == 0, "color draws match the recording");
+    report.check(model.getPointCount() == VoronoiModel::MAX_POINT_COUNT, "diagram filled by the taps");
+    report.check(soundPlayer.evictionCount > 0, "oldest points evicted");
+
+    // The trace ends while a point is dragged: its pin must not outlive the session
+    report.check(model.getPinnedMask() == 0, "pins released when the session ends");
+
+    return report.finish("REPLAY");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc == 3 && std::strcmp(argv[1], "--record") == 0) {
+        return record(argv[2]);
+    }
+    if (argc == 2) {
+        return replay(argv[1]);
+    }
+
+    std::printf("usage: %s [--record] <trace>\n", argv[0]);
+    return 2;
+}
@@ -0,0 +1,195 @@
+// Feed the synthetic taps and drags through TouchHandler into VoronoiModel
+//   SyntheticInputSource runs on a simulated clock. The touch task samples it
+//   every few milliseconds (handleInput()), the draw task applies the events
+//   once per frame (processEvents()) and steps the model. Every tap must add
+//   a point where it touched, and every drag must leave a point where the
+//   finger was last sampled.
+#include "InputTrace.h"
+#include "SoundPlayer.h"
+#include "SyntheticInputSource.h"
+#include "TestSupport.h"
+#include "TouchHandler.h"
+#include "VoronoiModel.h"
+#include <cstdio>
+
+namespace {
+
+const int WIDTH = 320;
+const int HEIGHT = 240;
+
+// Sampling interval of the touch task and frame interval of the draw task
+const int64_t SAMPLE_INTERVAL_US = 4000;
+const int SAMPLES_PER_FRAME = 4;
+
+// Number of scripted strokes (enough taps to evict the oldest points)
+const uint32_t STROKE_COUNT = 36U;
+
+// Simulated clock
+int64_t simulatedTimeUs = 0;
+
+int64_t getSimulatedTime() {
+    return simulatedTimeUs;
+}
+
+// Point colors (not checked)
+uint32_t getZero() {
+    return 0;
+}
+
+// Sound player that only counts the sounds
+class CountingSoundPlayer : public SoundPlayer {
+public:
+    void playSound(SoundType type) override {
+        if (type == SoundType::TOUCH) {
+            ++touchCount;
+        } else if (type == SoundType::EVICTION) {
+            ++evictionCount;
+        }
+    }
+
+    uint32_t touchCount = 0;
+    uint32_t evictionCount = 0;
+};
+
+// Input source that passes the synthetic strokes through and remembers how each one ended
+class ObservedInputSource : public InputSource {
+public:
+    // Finished stroke
+    struct Stroke {
+        bool isTap;
+        int16_t lastX;
+        int16_t lastY;
+    };
+
+    explicit ObservedInputSource(InputSource& input) : source(input) {}
+
+    void begin(TaskHandle_t task) override { source.begin(task); }
+
+    bool waitForActivity(uint32_t timeoutMs) override { return source.waitForActivity(timeoutMs); }
+
+    uint8_t read(TouchPoint* points, uint8_t maxCount) override {
+        const uint8_t count = source.read(points, maxCount);
+
+        if (count > 0) {
+            if (!isTouching) {
+                isTouching = true;
+                firstX = points[0].x;
+                firstY = points[0].y;
+            }
+            lastX = points[0].x;
+            lastY = points[0].y;
+        } else if (isTouching) {
+            isTouching = false;
+            finished = {lastX == firstX && lastY == firstY, lastX, lastY};
+            hasFinished = true;
+            ++strokeCount;
+        }
+
+        return count;
+    }
+
+    int64_t getLastActivityTimeUs() const override { return source.getLastActivityTimeUs(); }
+
+    // Take the stroke finished since the last call (false if none)
+    bool takeFinishedStroke(Stroke& stroke) {
+        if (!hasFinished) {
+            return false;
+        }
+        stroke = finished;
+        hasFinished = false;
+        return true;
+    }
+
+    uint32_t strokeCount = 0;
+
+private:
+    InputSource& source;
+    bool isTouching = false;
+    int16_t firstX = 0;
+    int16_t firstY = 0;
+    int16_t lastX = 0;
+    int16_t lastY = 0;
+    Stroke finished = {};
+    bool hasFinished = false;
+};
+
+// Whether the model has a point at the position
+bool hasPointAt(const VoronoiModel& model, int x, int y) {
+    for (std::size_t i = 0; i < model.getPointCount(); ++i) {
+        if (model.getPoints()[i].x == x && model.getPoints()[i].y == y) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+int main() {
+    FileStream console(stdout);
+    InputTrace inputTrace(console, &getSimulatedTime);
+    VoronoiModel model(WIDTH, HEIGHT, &getZero);
+    SyntheticInputSource synthetic(WIDTH, HEIGHT, &getSimulatedTime);
+    ObservedInputSource inputSource(synthetic);
+    CountingSoundPlayer soundPlayer;
+    TouchHandler touchHandler(model, soundPlayer, inputTrace, inputSource);
+    TestReport report;
+
+    report.check(model.allocateBuffers(), "buffers allocated");
+
+    // The first stroke starts one interval after begin()
+    inputSource.begin(nullptr);
+    report.check(!inputSource.waitForActivity(100U), "no activity before the first stroke");
+    simulatedTimeUs = 800000;
+    report.check(inputSource.waitForActivity(100U), "activity once the first stroke starts");
+
+    uint32_t tapCount = 0;
+    uint32_t dragCount = 0;
+    uint32_t misplacedTaps = 0;
+    uint32_t misplacedDrags = 0;
+    uint32_t frameCount = 0;
+
+    while (inputSource.strokeCount < STROKE_COUNT) {
+        // Touch task
+        for (int i = 0; i < SAMPLES_PER_FRAME; ++i) {
+            touchHandler.handleInput();
+            simulatedTimeUs += SAMPLE_INTERVAL_US;
+        }
+
+        // Draw task (checked between applying the events and the repulsive force)
+        touchHandler.processEvents();
+
+        ObservedInputSource::Stroke stroke = {};
+        if (inputSource.takeFinishedStroke(stroke)) {
+            if (stroke.isTap) {
+                ++tapCount;
+                const VoronoiModel::Point& newest = model.getPoints()[model.getPointCount() - 1];
+                if (newest.x != stroke.lastX || newest.y != stroke.lastY) {
+                    ++misplacedTaps;
+                }
+            } else {
+                ++dragCount;
+                if (!hasPointAt(model, stroke.lastX, stroke.lastY)) {
+                    ++misplacedDrags;
+                }
+            }
+        }
+
+        model.step(VoronoiCore::NoPaint());
+        touchHandler.finishFrame();
+        ++frameCount;
+    }
+
+    std::printf("%u frames: %u taps, %u drags, %u points, %u evictions\n", frameCount, tapCount, dragCount,
+                (unsigned)model.getPointCount(), soundPlayer.evictionCount);
+
+    report.check(tapCount > VoronoiModel::MAX_POINT_COUNT && dragCount > 0, "script has taps and drags");
+    report.check(soundPlayer.touchCount == tapCount, "every tap played the touch sound");
+    report.check(misplacedTaps == 0, "every tap added a point where it touched");
+    report.check(misplacedDrags == 0, "every drag left a point at its last sample");
+    report.check(model.getPointCount() == VoronoiModel::MAX_POINT_COUNT, "point count capped");
+    report.check(soundPlayer.evictionCount == tapCount - VoronoiModel::MAX_POINT_COUNT, "oldest points evicted");
+    report.check(model.getPinnedMask() == 0 && !touchHandler.hasActiveTouch(), "no touch or pin left");
+
+    return report.finish("TOUCH INPUT");
+}
@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+"""Decode a run-length compressed label-map stream into PPM frames.
+
+The stream is sent by the 'V' serial command. Capture it to a file, or read
+it straight from the serial port (requires pyserial):
+
+    python3 tools/decode_label_stream.py capture.bin frames/
+    python3 tools/decode_label_stream.py --port /dev/ttyUSB0 frames/
+
+Text printed on the same port between packets is skipped. Text that lands
+inside a packet (messages the firmware prints on its own while streaming)
+breaks its hash; such packets are dropped, and decoding resumes at the next
+keyframe.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = b"VLRS"
+FORMAT_VERSION = 2
+FLAG_KEYFRAME = 0x01
+NO_SEED = 0xFF
+POINT_RADIUS = 3
+
+HEADER = struct.Struct("<4sBBHHBIHI")
+SEED = struct.Struct("<hhH")
+ROW_HEADER = struct.Struct("<HH")
+HASH = struct.Struct("<I")
+
+
+def fnv1a(data):
+    value = 2166136261
+    for byte in data:
+        value = ((value ^ byte) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def rgb565_to_rgb888(color):
+    r = (color >> 11) & 0x1F
+    g = (color >> 5) & 0x3F
+    b = color & 0x1F
+    return bytes(((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)))
+
+
+class Decoder:
+    """Rebuild label maps from stream bytes.
+
+    on_frame(frame, width, height, labels, seeds) is called for every decoded
+    frame, with labels as bytes (one seed index per pixel) and seeds as
+    (x, y, color) tuples.
+    """
+
+    def __init__(self, on_frame):
+        self.on_frame = on_frame
+        self.buffer = bytearray()
+        self.labels = None
+        self.width = 0
+        self.height = 0
+        self.has_keyframe = False
+        self.packet_count = 0
+        self.keyframe_count = 0
+        self.dropped_count = 0
+        self.byte_count = 0
+
+    def feed(self, data):
+        self.buffer += data
+        while self._decode_packet():
+            pass
+
+    def _decode_packet(self):
+        # Skip anything before the next magic
+        start = self.buffer.find(MAGIC)
+        if start < 0:
+            del self.buffer[:max(0, len(self.buffer) - len(MAGIC) + 1)]
+            return False
+        del self.buffer[:start]
+
+        if len(self.buffer) < HEADER.size:
+            return False
+
+        (_, version, flags, width, height, seed_count, frame, row_count,
+         payload_size) = HEADER.unpack_from(self.buffer)
+        packet_size = HEADER.size + payload_size + HASH.size
+        if version != FORMAT_VERSION or payload_size > 1 << 20:
+            del self.buffer[:len(MAGIC)]
+            return True
+        if len(self.buffer) < packet_size:
+            return False
+
+        # The hash covers the header fields after the magic and the payload
+        payload = bytes(self.buffer[HEADER.size:HEADER.size + payload_size])
+        (expected,) = HASH.unpack_from(self.buffer, HEADER.size + payload_size)
+        if fnv1a(self.buffer[len(MAGIC):HEADER.size + payload_size]) != expected:
+            # Not a packet, or a corrupted one
+            self.dropped_count += 1
+            self.has_keyframe = False
+            del self.buffer[:len(MAGIC)]
+            return True
+        del self.buffer[:packet_size]
+
+        is_keyframe = bool(flags & FLAG_KEYFRAME)
+        if is_keyframe:
+            self.width, self.height = width, height
+            self.labels = bytearray([NO_SEED]) * (width * height)
+            self.has_keyframe = True
+            self.keyframe_count += 1
+        elif not self.has_keyframe:
+            return True
+
+        self.packet_count += 1
+        self.byte_count += packet_size
+        self._apply(frame, payload, seed_count, row_count)
+        return True
+
+    def _apply(self, frame, payload, seed_count, row_count):
+        seeds = [SEED.unpack_from(payload, i * SEED.size) for i in range(seed_count)]
+        offset = seed_count * SEED.size
+
+        for _ in range(row_count):
+            y, run_count = ROW_HEADER.unpack_from(payload, offset)
+            offset += ROW_HEADER.size
+            row = bytearray()
+            for i in range(run_count):
+                length = payload[offset + 2 * i]
+                label = payload[offset + 2 * i + 1]
+                row += bytes([label]) * length
+            offset += 2 * run_count
+            self.labels[y * self.width:(y + 1) * self.width] = row
+
+        self.on_frame(frame, self.width, self.height, bytes(self.labels), seeds)
+
+
+def ppm_writer(output_dir):
+    """Return an on_frame callback that writes every frame as a PPM file."""
+
+    def write_ppm(frame, width, height, labels, seeds):
+        palette = [rgb565_to_rgb888(color) for (_, _, color) in seeds]
+        black = b"\x00\x00\x00"
+        pixels = bytearray()
+        for label in labels:
+            pixels += palette[label] if label < len(palette) else black
+
+        # Point circles are drawn on top of the cells, as on the display
+        for (cx, cy, _) in seeds:
+            for y in range(cy - POINT_RADIUS, cy + POINT_RADIUS + 1):
+                for x in range(cx - POINT_RADIUS, cx + POINT_RADIUS + 1):
+                    inside = (x - cx) ** 2 + (y - cy) ** 2 <= POINT_RADIUS ** 2
+                    if inside and 0 <= x < width and 0 <= y < height:
+                        index = 3 * (y * width + x)
+                        pixels[index:index + 3] = b"\xff\xff\xff"
+
+        path = os.path.join(output_dir, "frame_%06u.ppm" % frame)
+        with open(path, "wb") as f:
+            f.write(b"P6\n%d %d\n255\n" % (width, height))
+            f.write(pixels)
+
+    return write_ppm
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", nargs="?", help="captured stream file")
+    parser.add_argument("output_dir", help="directory for the PPM frames")
+    parser.add_argument("--port", help="read from a serial port instead of a file")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    if not args.input and not args.port:
+        parser.error("either an input file or --port is required")
+
+    os.makedirs(args.output_dir, exist_ok=True)
+    decoder = Decoder(ppm_writer(args.output_dir))
+
+    try:
+        if args.port:
+            import serial
+            with serial.Serial(args.port, args.baud, timeout=0.1) as port:
+                port.write(b"V")
+                try:
+                    while True:
+                        decoder.feed(port.read(4096))
+                finally:
+                    port.write(b"V")
+        else:
+            with open(args.input, "rb") as f:
+                decoder.feed(f.read())
+    except KeyboardInterrupt:
+        pass
+
+    average = decoder.byte_count // decoder.packet_count if decoder.packet_count else 0
+    print("%d frames (%d keyframes), %d dropped, %d bytes per frame on average"
+          % (decoder.packet_count, decoder.keyframe_count, decoder.dropped_count, average),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()